@@ -0,0 +1,103 @@
+#include "../Other/TestPrefix.h"
+
+TEST_CASE("LockFreeBroadcast",
+          "[LockFreeBroadcast]")
+{
+    LockFreeBroadcast<String> broadcast(4, 2);
+    PublishSubject<String> subject;
+    subject.subscribe(broadcast);
+    String value;
+
+    IT("returns false if no values have been retrieved")
+    {
+        CHECK_FALSE(broadcast.tryRead(0, value));
+        REQUIRE_FALSE(broadcast.tryReadAll(1, value));
+    }
+
+    IT("delivers every value to every reader, in order")
+    {
+        subject.onNext("First");
+        subject.onNext("Second");
+
+        for (int reader = 0; reader < broadcast.getNumReaders(); ++reader) {
+            CHECK(broadcast.tryRead(reader, value));
+            CHECK(value == "First");
+            CHECK(broadcast.tryRead(reader, value));
+            CHECK(value == "Second");
+            CHECK_FALSE(broadcast.tryRead(reader, value));
+        }
+    }
+
+    IT("visits values in place")
+    {
+        subject.onNext("Hello");
+
+        Array<const String*> addresses;
+        CHECK(broadcast.tryVisit(0, [&](const String& s) { addresses.add(&s); }));
+        CHECK(broadcast.tryVisit(1, [&](const String& s) { addresses.add(&s); }));
+
+        REQUIRE(addresses.size() == 2);
+        REQUIRE(addresses[0] == addresses[1]);
+    }
+
+    IT("reads the newest value with tryReadAll")
+    {
+        subject.onNext("1");
+        subject.onNext("2");
+        subject.onNext("3");
+
+        CHECK(broadcast.tryReadAll(0, value));
+        CHECK(value == "3");
+        CHECK_FALSE(broadcast.tryRead(0, value));
+
+        CHECK(broadcast.tryRead(1, value));
+        REQUIRE(value == "1");
+    }
+
+    IT("drops new values while the slowest reader is a full ring behind")
+    {
+        for (int i = 0; i < 6; ++i)
+            subject.onNext(String(i));
+
+        CHECK(broadcast.tryReadAll(0, value));
+        CHECK(value == "3");
+
+        // Reader 1 hasn't read anything, so the ring was still full
+        subject.onNext("Dropped");
+        CHECK_FALSE(broadcast.tryRead(0, value));
+
+        Array<String> values;
+        while (broadcast.tryRead(1, value))
+            values.add(value);
+
+        ReaX_RequireValues(values, "0", "1", "2", "3");
+    }
+
+    IT("delivers all values to readers on other threads")
+    {
+        LockFreeBroadcast<int> numbers(1000, 3);
+        std::vector<int> sums(3, 0);
+        std::vector<std::thread> readers;
+
+        for (int reader = 0; reader < 3; ++reader) {
+            readers.emplace_back([&numbers, &sums, reader]() {
+                int next = 0;
+
+                for (int numRead = 0; numRead < 1000;) {
+                    if (numbers.tryRead(reader, next)) {
+                        sums[static_cast<size_t>(reader)] += next;
+                        ++numRead;
+                    }
+                }
+            });
+        }
+
+        for (int i = 1; i <= 1000; ++i)
+            numbers.onNext(i);
+
+        for (auto& reader : readers)
+            reader.join();
+
+        REQUIRE(sums == std::vector<int>(3, 500500));
+    }
+}
@@ -49,6 +49,20 @@ TEST_CASE("LockFreeTarget",
         REQUIRE(anotherValue == "anotherValue");
     }
     
+    IT("retrieves repeated String values")
+    {
+        LockFreeTarget<String> target;
+        Observable<String>::repeat("x", 3).subscribe(target);
+        
+        String value;
+        for (int i = 0; i < 3; ++i) {
+            CHECK(target.tryDequeue(value));
+            CHECK(value == "x");
+        }
+        
+        REQUIRE_FALSE(target.tryDequeue(value));
+    }
+    
     IT("retrieves other non-primitive values")
     {
         PublishSubject<Point<int>> subject;
@@ -138,22 +152,23 @@ TEST_CASE("LockFreeTarget",
         LockFreeTarget<CopyAndMoveConstructible> target;
         CopyAndMoveConstructible::Counters counters;
         
-        IT("copies when passing an rvalue to onNext")
+        IT("moves into the queue when passing an rvalue to onNext")
         {
+            // Into the any, out of the any, and into the queue
             target.onNext(CopyAndMoveConstructible(&counters));
             
-            CHECK(counters.numCopyConstructions == 1);
-            CHECK(counters.numMoveConstructions == 1);
+            CHECK(counters.numCopyConstructions == 0);
+            CHECK(counters.numMoveConstructions == 3);
             CHECK(counters.numCopyAssignments == 0);
             REQUIRE(counters.numMoveAssignments == 0);
             
-            IT("uses move assignment when emptying the queue, and makes no further copies")
+            IT("uses move assignment when emptying the queue, and makes no copies")
             {
                 CopyAndMoveConstructible value(nullptr);
                 target.tryDequeueAll(value);
                 
-                CHECK(counters.numCopyConstructions == 1);
-                CHECK(counters.numMoveConstructions == 1);
+                CHECK(counters.numCopyConstructions == 0);
+                CHECK(counters.numMoveConstructions == 3);
                 CHECK(counters.numCopyAssignments == 0);
                 REQUIRE(counters.numMoveAssignments == 1);
             }
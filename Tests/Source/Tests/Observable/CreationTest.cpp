@@ -225,6 +225,100 @@ TEST_CASE("Observable::from",
 }
 
 
+#if REAX_HAS_COROUTINES
+namespace {
+Generator<int> countUp(int* numResumes)
+{
+    for (int i = 1;; ++i) {
+        (*numResumes)++;
+        co_yield i;
+    }
+}
+
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+DetachedTask collectAwaitedValues(Observable<int> ints, Observable<String> strings, Array<int>& results)
+{
+    results.add(co_await ints.first());
+
+    AsyncIterator<int> iterator(ints.take(2));
+    while (auto value = co_await iterator.next())
+        results.add(*value);
+
+    results.add((co_await strings.first()).getIntValue());
+}
+}
+
+TEST_CASE("Observable::fromGenerator",
+          "[Observable][Observable::fromGenerator]")
+{
+    Array<int> values;
+    int numResumes = 0;
+    auto observable = Observable<int>::fromGenerator([&]() { return countUp(&numResumes); });
+
+    IT("resumes the generator only for requested values")
+    {
+        auto subscription = observable.map([](int i) { return i * 10; }).subscribe([&](int i) { values.add(i); });
+        CHECK(values.isEmpty());
+        CHECK(numResumes == 0);
+
+        subscription.request(2);
+        ReaX_CheckValues(values, 10, 20);
+        CHECK(numResumes == 2);
+
+        subscription.request(1);
+        ReaX_CheckValues(values, 10, 20, 30);
+        REQUIRE(numResumes == 3);
+
+        subscription.unsubscribe();
+    }
+
+    IT("resumes the generator only as often as needed if nothing can request values")
+    {
+        ReaX_CollectValues(observable.take(3), values);
+
+        ReaX_RequireValues(values, 1, 2, 3);
+        REQUIRE(numResumes == 3);
+    }
+
+    IT("runs the generator eagerly behind a backpressure operator")
+    {
+        auto subscription = observable.take(5).onBackpressureBuffer(10).subscribe([&](int i) { values.add(i); });
+        CHECK(values.isEmpty());
+        CHECK(numResumes == 5);
+
+        subscription.request(2);
+        ReaX_RequireValues(values, 1, 2);
+
+        subscription.unsubscribe();
+    }
+
+    IT("can be awaited in a coroutine")
+    {
+        PublishSubject<String> subject;
+        Array<int> results;
+        collectAwaitedValues(observable, subject, results);
+
+        // The coroutine should be suspended, waiting for the subject
+        ReaX_CheckValues(results, 1, 1, 2);
+
+        subject.onNext("42");
+        ReaX_RequireValues(results, 1, 1, 2, 42);
+    }
+}
+#endif
+
+
 TEST_CASE("Observable::fromValue",
           "[Observable][Observable::fromValue]")
 {
@@ -401,23 +495,34 @@ TEST_CASE("Observable::interval",
 {
     IT("can create an interval below one second")
     {
-        auto o = Observable<int>::interval(RelativeTime::seconds(0.04)).take(3);
-        auto lastTime = Time::getCurrentTime();
-        Array<RelativeTime> intervals;
+        VirtualClock clock;
+        Array<RelativeTime> times;
         Array<int> ints;
-        o.subscribe([&](int i) {
-            auto time = Time::getCurrentTime();
-            intervals.add(time - lastTime);
-            lastTime = time;
-            ints.add(i);
-        });
+        ReaX_CollectValues(Observable<int>::interval(RelativeTime::seconds(0.04), Scheduler::virtualTime(clock)).take(3).map([&](int i) {
+            times.add(clock.getElapsedTime());
+            return i;
+        }),
+                           ints);
+        CHECK(ints.isEmpty());
 
-        CHECK(intervals.size() == 3);
-        REQUIRE(intervals[0].inSeconds() == Approx(0).epsilon(0.03));
-        REQUIRE(intervals[1].inSeconds() == Approx(0.04).epsilon(0.03));
-        REQUIRE(intervals[2].inSeconds() == Approx(0.04).epsilon(0.03));
+        clock.advanceBy(RelativeTime::milliseconds(100));
+
+        ReaX_CheckValues(ints, 1, 2, 3);
+        REQUIRE(times[0].inSeconds() == Approx(0));
+        REQUIRE(times[1].inSeconds() == Approx(0.04));
+        REQUIRE(times[2].inSeconds() == Approx(0.08));
+    }
+
+    IT("emits on the shared timer thread by default")
+    {
+        Thread::ThreadID threadID = nullptr;
+        WaitableEvent completed;
+        DisposeBag disposeBag;
+        Observable<int>::interval(RelativeTime::milliseconds(1)).take(2).subscribe([&](int) { threadID = Thread::getCurrentThreadId(); }, [](std::exception_ptr) {}, [&]() { completed.signal(); }).disposedBy(disposeBag);
 
-        ReaX_RequireValues(ints, 1, 2, 3);
+        REQUIRE(completed.wait(1000));
+        REQUIRE(threadID != nullptr);
+        REQUIRE(threadID != Thread::getCurrentThreadId());
     }
 }
 
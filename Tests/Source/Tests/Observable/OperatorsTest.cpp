@@ -104,6 +104,93 @@ TEST_CASE("Observable::concat",
 
         ReaX_RequireValues(values, var("Hello"), var("World"), var(1.5), var(2.32), var(5.6));
     }
+
+    IT("concatenates 100000 Observables on a trampoline without growing the stack")
+    {
+        Array<Observable<int>> others;
+        for (int i = 1; i < 100000; ++i)
+            others.add(Observable<int>::just(i));
+
+        // The distance between the stack addresses of the first and the deepest onNext call
+        Array<int> ints;
+        pointer_sized_int firstStackAddress = 0;
+        pointer_sized_int maxStackDistance = 0;
+        DisposeBag disposeBag;
+        Observable<int>::just(0).concat(others, Scheduler::trampoline()).subscribe([&](int i) {
+            const char marker = 0;
+            const auto stackAddress = reinterpret_cast<pointer_sized_int>(&marker);
+
+            if (ints.isEmpty())
+                firstStackAddress = stackAddress;
+
+            maxStackDistance = jmax(maxStackDistance, std::abs(stackAddress - firstStackAddress));
+            ints.add(i);
+        }).disposedBy(disposeBag);
+
+        REQUIRE(ints.size() == 100000);
+        REQUIRE(ints.getFirst() == 0);
+        REQUIRE(ints.getLast() == 99999);
+
+        // Recursing for each Observable would take megabytes
+        REQUIRE(maxStackDistance < 64 * 1024);
+    }
+}
+
+
+TEST_CASE("Observable::debounce",
+          "[Observable][Observable::debounce]")
+{
+    PublishSubject<int> subject;
+    Array<int> values;
+
+    VirtualClock clock;
+    const auto scheduler = Scheduler::virtualTime(clock);
+
+    IT("emits the latest value after a pause")
+    {
+        ReaX_CollectValues(subject.debounce(RelativeTime::milliseconds(20), scheduler), values);
+
+        subject.onNext(1);
+        subject.onNext(2);
+        subject.onNext(3);
+        clock.advanceBy(RelativeTime::milliseconds(10));
+        CHECK(values.isEmpty());
+
+        clock.advanceBy(RelativeTime::milliseconds(20));
+        ReaX_CheckValues(values, 3);
+
+        // Nothing new to emit
+        clock.advanceBy(RelativeTime::milliseconds(40));
+        ReaX_RequireValues(values, 3);
+    }
+
+    IT("emits the pending value right away when completing")
+    {
+        ReaX_CollectValues(subject.debounce(RelativeTime::seconds(10), scheduler), values);
+
+        subject.onNext(1);
+        subject.onCompleted();
+
+        ReaX_RequireValues(values, 1);
+    }
+
+    IT("emits on the shared timer thread by default")
+    {
+        Thread::ThreadID threadID = nullptr;
+        WaitableEvent emitted;
+        DisposeBag disposeBag;
+        subject.debounce(RelativeTime::milliseconds(1)).subscribe([&](int i) {
+            values.add(i);
+            threadID = Thread::getCurrentThreadId();
+            emitted.signal();
+        }).disposedBy(disposeBag);
+
+        subject.onNext(1);
+
+        REQUIRE(emitted.wait(1000));
+        REQUIRE(threadID != Thread::getCurrentThreadId());
+        ReaX_RequireValues(values, 1);
+    }
 }
 
 
@@ -222,6 +309,28 @@ TEST_CASE("Observable::filter",
 }
 
 
+TEST_CASE("Observable::first",
+          "[Observable][Observable::first]")
+{
+    Array<String> values;
+
+    IT("emits only the first value")
+    {
+        ReaX_CollectValues(Observable<String>::from({ "First", "Second", "Third" }).first(), values);
+
+        ReaX_RequireValues(values, "First");
+    }
+
+    IT("notifies onError if there is no value")
+    {
+        bool onErrorCalled = false;
+        Observable<String>::empty().first().subscribe([](String) {}, [&](std::exception_ptr) { onErrorCalled = true; });
+
+        REQUIRE(onErrorCalled);
+    }
+}
+
+
 TEST_CASE("Observable::flatMap",
           "[Observable][Observable::flatMap]")
 {
@@ -236,6 +345,50 @@ TEST_CASE("Observable::flatMap",
 
         ReaX_RequireValues(values, "hello", "HELLO!", "world", "WORLD!");
     }
+
+    IT("subscribes to the returned Observables on a trampoline")
+    {
+        auto o = Observable<String>::from({ "Hello", "World" }).flatMap([](String s) {
+            return Observable<String>::from({ s.toLowerCase(), s.toUpperCase() + "!" });
+        },
+                                                                        Scheduler::trampoline());
+        ReaX_CollectValues(o, values);
+
+        ReaX_RequireValues(values, "hello", "HELLO!", "world", "WORLD!");
+    }
+
+    IT("runs 1000 recursive flatMaps on a trampoline without growing the stack with each level")
+    {
+        // The distance between the stack addresses of the first and the deepest call
+        int numCalls = 0;
+        pointer_sized_int firstStackAddress = 0;
+        pointer_sized_int maxStackDistance = 0;
+
+        std::function<Observable<int>(int)> countDown;
+        countDown = [&](int i) {
+            const char marker = 0;
+            const auto stackAddress = reinterpret_cast<pointer_sized_int>(&marker);
+
+            if (numCalls++ == 0)
+                firstStackAddress = stackAddress;
+
+            maxStackDistance = jmax(maxStackDistance, std::abs(stackAddress - firstStackAddress));
+
+            if (i == 0)
+                return Observable<int>::just(0);
+
+            return Observable<int>::just(i - 1).flatMap([&](int next) { return countDown(next); }, Scheduler::trampoline());
+        };
+
+        Array<int> ints;
+        ReaX_CollectValues(Observable<int>::just(1000).flatMap([&](int i) { return countDown(i); }, Scheduler::trampoline()), ints);
+
+        ReaX_CheckValues(ints, 0);
+        REQUIRE(numCalls == 1001);
+
+        // Subscribing to each level from the previous one would take megabytes
+        REQUIRE(maxStackDistance < 64 * 1024);
+    }
 }
 
 
@@ -322,6 +475,98 @@ TEST_CASE("Observable::merge",
 }
 
 
+TEST_CASE("Observable::onBackpressure",
+          "[Observable][Observable::onBackpressureBuffer][Observable::onBackpressureDrop][Observable::onBackpressureLatest]")
+{
+    Array<int> values;
+    PublishSubject<int> subject;
+
+    IT("buffers values until they are requested")
+    {
+        auto subscription = subject.onBackpressureBuffer(10).subscribe([&](int i) { values.add(i); });
+        subject.onNext(1);
+        subject.onNext(2);
+        subject.onNext(3);
+        CHECK(values.isEmpty());
+
+        subscription.request(2);
+        ReaX_CheckValues(values, 1, 2);
+
+        subscription.request(2);
+        ReaX_CheckValues(values, 1, 2, 3);
+
+        // One value is still requested, so this should be emitted immediately
+        subject.onNext(4);
+        ReaX_RequireValues(values, 1, 2, 3, 4);
+    }
+
+    IT("notifies onError when the buffer overflows")
+    {
+        bool onErrorCalled = false;
+        subject.onBackpressureBuffer(2).subscribe([&](int i) { values.add(i); }, [&](std::exception_ptr) { onErrorCalled = true; });
+        subject.onNext(1);
+        subject.onNext(2);
+        CHECK_FALSE(onErrorCalled);
+
+        subject.onNext(3);
+        REQUIRE(onErrorCalled);
+    }
+
+    IT("drops values that haven't been requested")
+    {
+        auto subscription = subject.onBackpressureDrop().subscribe([&](int i) { values.add(i); });
+        subject.onNext(1);
+        subscription.request(1);
+        subject.onNext(2);
+        subject.onNext(3);
+
+        ReaX_RequireValues(values, 2);
+    }
+
+    IT("keeps the latest value that hasn't been requested")
+    {
+        auto subscription = subject.onBackpressureLatest().subscribe([&](int i) { values.add(i); });
+        subject.onNext(1);
+        subject.onNext(2);
+        subject.onNext(3);
+        CHECK(values.isEmpty());
+
+        subscription.request(1);
+        ReaX_RequireValues(values, 3);
+    }
+
+    IT("can request values from within onNext")
+    {
+        Subscription* subscription = nullptr;
+        auto s = Observable<int>::range(1, 5).onBackpressureBuffer(5).subscribe([&](int i) {
+            values.add(i);
+            subscription->request(1);
+        });
+        subscription = &s;
+        s.request(1);
+
+        ReaX_RequireValues(values, 1, 2, 3, 4, 5);
+    }
+
+    IT("forwards requests when subscribing on another thread")
+    {
+        std::atomic<int> numValues(0);
+        std::atomic<bool> completed(false);
+        auto subscription = Observable<int>::range(1, 5).onBackpressureBuffer(5).subscribeOn(Scheduler::newThread()).subscribe([&](int) { ++numValues; }, [](std::exception_ptr) {}, [&]() { completed = true; });
+
+        // May be called before the operator has subscribed on the other thread
+        subscription.request(2);
+        ReaX_RunDispatchLoopUntil(numValues == 2);
+        Thread::sleep(20);
+        CHECK(numValues == 2);
+
+        subscription.request(3);
+        ReaX_RunDispatchLoopUntil(completed);
+        REQUIRE(numValues == 5);
+    }
+}
+
+
 TEST_CASE("Observable::reduce",
           "[Observable][Observable::reduce]")
 {
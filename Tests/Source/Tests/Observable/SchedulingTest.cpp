@@ -1,5 +1,88 @@
 #include "../../Other/TestPrefix.h"
 
+#if JUCE_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Counts allocations, deallocations, and the copies and destructions of CountedValues on the current thread, while an instance exists
+    thread_local bool isCounting = false;
+    int numAllocations = 0;
+    int numDeallocations = 0;
+    int numCopies = 0;
+    int numDestructions = 0;
+
+    struct ScopedCounter
+    {
+        ScopedCounter()
+        {
+            numAllocations = 0;
+            numDeallocations = 0;
+            numCopies = 0;
+            numDestructions = 0;
+            isCounting = true;
+        }
+
+        ~ScopedCounter()
+        {
+            isCounting = false;
+        }
+    };
+
+    // A value that owns memory, like a String. As long as it's neither copied nor destroyed, no memory is allocated or freed for it.
+    struct CountedValue
+    {
+        explicit CountedValue(int length)
+        : text(static_cast<size_t>(length), 'x')
+        {}
+
+        CountedValue(const CountedValue& other)
+        : text(other.text)
+        {
+            if (isCounting)
+                ++numCopies;
+        }
+
+        ~CountedValue()
+        {
+            if (isCounting)
+                ++numDestructions;
+        }
+
+        CountedValue& operator=(const CountedValue&) = default;
+
+        std::string text;
+    };
+}
+
+void* operator new(std::size_t size)
+{
+    if (isCounting)
+        ++numAllocations;
+
+    if (void* pointer = std::malloc(size > 0 ? size : 1))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer && isCounting)
+        ++numDeallocations;
+
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
 
 TEST_CASE("Observable::observeOn",
           "[Observable][Observable::observeOn]")
@@ -49,6 +132,73 @@ TEST_CASE("Observable::observeOn",
         ReaX_RequireValues(values, 24, 48, 72);
     }
 
+    IT("can schedule to threads with options")
+    {
+        ThreadOptions options;
+        options.name = "ReaX Test";
+        options.priority = 3;
+        options.affinityMask = 1;
+
+        const auto messageThreadID = Thread::getCurrentThreadId();
+        std::atomic<Thread::ThreadID> backgroundThreadID(messageThreadID);
+        std::atomic<Thread::ThreadID> newThreadID(messageThreadID);
+
+        values = observable.observeOn(Scheduler::backgroundThread(options)).map([&](int i) {
+            backgroundThreadID = Thread::getCurrentThreadId();
+            return i;
+        }).observeOn(Scheduler::newThread(options)).map([&](int i) {
+            newThreadID = Thread::getCurrentThreadId();
+            return i;
+        }).toArray();
+
+        ReaX_RequireValues(values, 1, 2, 3);
+        REQUIRE(backgroundThreadID != messageThreadID);
+        REQUIRE(newThreadID != messageThreadID);
+    }
+
+#if JUCE_LINUX
+    IT("applies the options to the threads")
+    {
+        ThreadOptions options;
+        options.name = "ReaX Options";
+        options.priority = 3;
+        options.affinityMask = 1;
+
+        char name[16] = {};
+        int niceValue = 0;
+        cpu_set_t affinity;
+        CPU_ZERO(&affinity);
+
+        values = observable.observeOn(Scheduler::newThread(options)).map([&](int i) {
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            niceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+            sched_getaffinity(0, sizeof(affinity), &affinity);
+            return i;
+        }).toArray();
+
+        ReaX_RequireValues(values, 1, 2, 3);
+        REQUIRE(String(name) == "ReaX Options");
+        REQUIRE(CPU_COUNT(&affinity) == 1);
+        REQUIRE(CPU_ISSET(0, &affinity));
+
+        // Priority 3 is nice value 8. It's higher if the tests already run with a higher nice value.
+        REQUIRE(niceValue >= 8);
+    }
+
+    IT("doesn't change the priority by default")
+    {
+        const int messageThreadNiceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+        int niceValue = 0;
+
+        values = observable.observeOn(Scheduler::newThread()).map([&](int i) {
+            niceValue = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+            return i;
+        }).toArray();
+
+        REQUIRE(niceValue == messageThreadNiceValue);
+    }
+#endif
+
     IT("can schedule to the message thread")
     {
         auto onMessageThread = observable.observeOn(Scheduler::messageThread()).map([](int i) {
@@ -64,4 +214,450 @@ TEST_CASE("Observable::observeOn",
 
         ReaX_RequireValues(values, 2, 4, 6);
     }
+
+    IT("delivers values on the message thread without waiting for a timer")
+    {
+        ReaX_CollectValues(observable.observeOn(Scheduler::messageThread()), values);
+        CHECK(values.isEmpty());
+
+        // A single pass through the dispatch loop should be enough
+        ReaX_RunDispatchLoop(1);
+
+        ReaX_RequireValues(values, 1, 2, 3);
+    }
+
+    IT("takes turns between subscriptions on the message thread")
+    {
+        ReaX_CollectValues(observable.observeOn(Scheduler::messageThread()), values);
+        ReaX_CollectValues(Observable<int>::from({ 10, 20, 30 }).observeOn(Scheduler::messageThread()), values);
+
+        ReaX_RunDispatchLoopUntil(values.size() == 6);
+
+        ReaX_RequireValues(values, 1, 10, 2, 20, 3, 30);
+    }
+
+    IT("processes values with a higher priority first on the message thread")
+    {
+        ReaX_CollectValues(observable.observeOn(Scheduler::messageThread(Scheduler::Priority::Background)), values);
+        ReaX_CollectValues(Observable<int>::from({ 4, 5, 6 }).observeOn(Scheduler::messageThread()), values);
+        ReaX_CollectValues(Observable<int>::from({ 10, 20, 30 }).observeOn(Scheduler::messageThread(Scheduler::Priority::High)), values);
+
+        ReaX_RunDispatchLoopUntil(values.size() == 9);
+
+        ReaX_RequireValues(values, 10, 20, 30, 4, 5, 6, 1, 2, 3);
+    }
+
+    IT("delivers values inline on the message thread if the queue is idle")
+    {
+        PublishSubject<int> subject;
+        ReaX_CollectValues(subject.observeOn(Scheduler::messageThread(Scheduler::Priority::Normal, Scheduler::Delivery::InlineIfIdle)), values);
+
+        subject.onNext(1);
+        ReaX_CheckValues(values, 1);
+
+        // The previous value has been delivered already, so these are delivered inline too
+        subject.onNext(2);
+        subject.onNext(3);
+
+        ReaX_RequireValues(values, 1, 2, 3);
+    }
+
+    IT("delivers values that are emitted during an inline delivery after it, on the message thread")
+    {
+        PublishSubject<int> subject;
+        int depth = 0;
+        int maxDepth = 0;
+        DisposeBag disposeBag;
+        subject.observeOn(Scheduler::messageThread(Scheduler::Priority::Normal, Scheduler::Delivery::InlineIfIdle)).subscribe([&](int i) {
+            maxDepth = jmax(maxDepth, ++depth);
+            values.add(i);
+
+            if (i == 1)
+                subject.onNext(2);
+
+            --depth;
+        }).disposedBy(disposeBag);
+
+        subject.onNext(1);
+        ReaX_CheckValues(values, 1, 2);
+
+        // The second value must not be delivered from within the first onNext call
+        REQUIRE(maxDepth == 1);
+    }
+
+    IT("queues values on the message thread if other values are already waiting")
+    {
+        PublishSubject<int> subject;
+        ReaX_CollectValues(subject.observeOn(Scheduler::messageThread(Scheduler::Priority::Normal, Scheduler::Delivery::InlineIfIdle)), values);
+
+        // Emitted on another thread, so it's queued
+        std::thread([&]() { subject.onNext(1); }).join();
+
+        subject.onNext(2);
+        subject.onNext(3);
+        CHECK(values.isEmpty());
+
+        ReaX_RunDispatchLoopUntil(values.size() == 3);
+        ReaX_RequireValues(values, 1, 2, 3);
+    }
+
+    IT("only delivers the latest value with observeOnLatest")
+    {
+        DropCounter dropCounter;
+        PublishSubject<int> subject;
+        ReaX_CollectValues(subject.observeOnLatest(Scheduler::messageThread(), dropCounter), values);
+
+        for (int i = 1; i <= 500; ++i)
+            subject.onNext(i);
+
+        ReaX_RunDispatchLoopUntil(values.size() == 1);
+        REQUIRE(dropCounter.getNumDroppedValues() == 499);
+
+        subject.onNext(501);
+        ReaX_RunDispatchLoopUntil(values.size() == 2);
+
+        ReaX_RequireValues(values, 500, 501);
+    }
+
+    IT("can schedule to a thread pool")
+    {
+        CriticalSection criticalSection;
+        SortedSet<Thread::ThreadID> threadIDs;
+        const auto messageThreadID = Thread::getCurrentThreadId();
+
+        auto onThreadPool = Observable<int>::range(1, 1000).observeOn(Scheduler::threadPool(4)).map([&](int i) {
+            const ScopedLock lock(criticalSection);
+            threadIDs.add(Thread::getCurrentThreadId());
+            return i;
+        });
+
+        // Wait blocking
+        values = onThreadPool.toArray();
+
+        // Values are still processed in order
+        REQUIRE(values.size() == 1000);
+        for (int i = 0; i < values.size(); ++i)
+            REQUIRE(values[i] == i + 1);
+
+        REQUIRE_FALSE(threadIDs.contains(messageThreadID));
+    }
+
+    IT("keeps the order of each subscription on a thread pool")
+    {
+        Array<int> firstValues, secondValues;
+        std::atomic<int> numCompleted(0);
+        DisposeBag disposeBag;
+
+        Observable<int>::range(1, 500).observeOn(Scheduler::threadPool(4)).subscribe([&](int i) { firstValues.add(i); }, [](std::exception_ptr) {}, [&]() { ++numCompleted; }).disposedBy(disposeBag);
+        Observable<int>::range(1001, 1500).observeOn(Scheduler::threadPool(4)).subscribe([&](int i) { secondValues.add(i); }, [](std::exception_ptr) {}, [&]() { ++numCompleted; }).disposedBy(disposeBag);
+
+        ReaX_RunDispatchLoopUntil(numCompleted == 2);
+
+        REQUIRE(firstValues.size() == 500);
+        REQUIRE(secondValues.size() == 500);
+        for (int i = 0; i < 500; ++i) {
+            REQUIRE(firstValues[i] == i + 1);
+            REQUIRE(secondValues[i] == i + 1001);
+        }
+    }
+
+    IT("can schedule to an existing juce::ThreadPool")
+    {
+        ThreadPool threadPool(2);
+        CriticalSection criticalSection;
+        SortedSet<Thread::ThreadID> threadIDs;
+
+        auto onThreadPool = Observable<int>::range(1, 1000).observeOn(Scheduler::fromThreadPool(threadPool)).map([&](int i) {
+            const ScopedLock lock(criticalSection);
+            threadIDs.add(Thread::getCurrentThreadId());
+            return i;
+        });
+
+        values = onThreadPool.toArray();
+
+        REQUIRE(values.size() == 1000);
+        for (int i = 0; i < values.size(); ++i)
+            REQUIRE(values[i] == i + 1);
+
+        REQUIRE_FALSE(threadIDs.contains(Thread::getCurrentThreadId()));
+    }
+}
+
+
+TEST_CASE("Observable::subscribeOn",
+          "[Observable][Observable::subscribeOn]")
+{
+    IT("runs the subscription on the given scheduler")
+    {
+        const auto messageThreadID = Thread::getCurrentThreadId();
+        std::atomic<Thread::ThreadID> subscribeThreadID(messageThreadID);
+
+        auto observable = Observable<int>::create([&](Observer<int> observer) {
+            subscribeThreadID = Thread::getCurrentThreadId();
+            observer.onNext(42);
+            observer.onCompleted();
+        });
+
+        Array<int> values;
+        bool completed = false;
+        DisposeBag disposeBag;
+        observable.subscribeOn(Scheduler::newThread()).observeOn(Scheduler::messageThread()).subscribe([&](int i) { values.add(i); }, [](std::exception_ptr) {}, [&]() { completed = true; }).disposedBy(disposeBag);
+
+        // Nothing happens synchronously
+        CHECK(values.isEmpty());
+
+        ReaX_RunDispatchLoopUntil(completed);
+
+        ReaX_RequireValues(values, 42);
+        REQUIRE(subscribeThreadID != messageThreadID);
+    }
+}
+
+
+TEST_CASE("Observable::toArrayAsync",
+          "[Observable][Observable::toArray][Observable::toArrayAsync]")
+{
+    Array<int> values;
+    auto observable = Observable<int>::range(1, 1000);
+
+    IT("collects values when passing a size hint to toArray")
+    {
+        values = observable.toArray(1000);
+
+        REQUIRE(values.size() == 1000);
+        REQUIRE(values.getLast() == 1000);
+    }
+
+    IT("collects values from the message thread without blocking")
+    {
+        bool completed = false;
+        auto subscription = observable.observeOn(Scheduler::messageThread()).toArrayAsync(Scheduler::messageThread(), 1000, [&](const Array<int>& allValues) {
+            CHECK(MessageManager::getInstance()->isThisTheMessageThread());
+            values = allValues;
+            completed = true;
+        });
+
+        // Nothing should be collected before the dispatch loop runs
+        CHECK_FALSE(completed);
+
+        ReaX_RunDispatchLoopUntil(completed);
+        REQUIRE(values.size() == 1000);
+        REQUIRE(values.getFirst() == 1);
+    }
+
+    IT("does not call onCompleted after unsubscribing")
+    {
+        bool completed = false;
+        auto subscription = observable.observeOn(Scheduler::backgroundThread()).toArrayAsync(Scheduler::messageThread(), [&](const Array<int>&) { completed = true; });
+        subscription.unsubscribe();
+        ReaX_RunDispatchLoop(20);
+
+        REQUIRE_FALSE(completed);
+    }
+}
+
+
+TEST_CASE("Scheduler::realtime",
+          "[Scheduler][Scheduler::realtime]")
+{
+    RealtimeDrainPoint drainPoint(16);
+    auto observable = Observable<String>::from({ "a", "bb", "ccc" });
+
+    IT("delivers values when the drain point is drained")
+    {
+        Array<String> values;
+        ReaX_CollectValues(observable.observeOn(Scheduler::realtime(drainPoint)), values);
+        CHECK(values.isEmpty());
+
+        drainPoint.drain();
+
+        ReaX_RequireValues(values, "a", "bb", "ccc");
+    }
+
+    IT("does not allocate or free memory when draining")
+    {
+        int lengths[3] = { 0, 0, 0 };
+        int numValues = 0;
+        bool completed = false;
+
+        DisposeBag disposeBag;
+        Observable<CountedValue>::from({ CountedValue(1), CountedValue(2), CountedValue(3) }).observeOn(Scheduler::realtime(drainPoint)).subscribe([&](const CountedValue& value) { lengths[numValues++] = static_cast<int>(value.text.size()); }, [](std::exception_ptr) {}, [&]() { completed = true; }).disposedBy(disposeBag);
+
+        {
+            const ScopedCounter counter;
+            drainPoint.drain();
+        }
+
+        REQUIRE(numAllocations == 0);
+        REQUIRE(numDeallocations == 0);
+        REQUIRE(numCopies == 0);
+        REQUIRE(numDestructions == 0);
+        REQUIRE(numValues == 3);
+        REQUIRE(lengths[2] == 3);
+
+        // onCompleted is delivered on the message thread
+        CHECK_FALSE(completed);
+        ReaX_RunDispatchLoopUntil(completed);
+    }
+
+    IT("drops values if the queue is full")
+    {
+        Array<int> values;
+        ReaX_CollectValues(Observable<int>::range(1, 100).observeOn(Scheduler::realtime(drainPoint)), values);
+
+        drainPoint.drain();
+
+        REQUIRE(values.size() < 100);
+        REQUIRE(values.getFirst() == 1);
+        REQUIRE(drainPoint.getNumDroppedValues() == uint64(100 - values.size()));
+    }
+}
+
+TEST_CASE("Scheduler::virtualTime",
+          "[Scheduler][Scheduler::virtualTime]")
+{
+    VirtualClock clock;
+    const auto scheduler = Scheduler::virtualTime(clock);
+    PublishSubject<int> subject;
+
+    IT("emits an hour of intervals without waiting")
+    {
+        Array<int> values;
+        ReaX_CollectValues(Observable<int>::interval(RelativeTime::seconds(1), scheduler), values);
+        CHECK(values.isEmpty());
+
+        clock.advanceBy(RelativeTime::hours(1));
+
+        REQUIRE(values.size() == 3601);
+        REQUIRE(values.getFirst() == 1);
+        REQUIRE(values.getLast() == 3601);
+        REQUIRE(clock.getElapsedTime() == RelativeTime::hours(1));
+    }
+
+    IT("debounces values in virtual time")
+    {
+        Array<int> values;
+        ReaX_CollectValues(subject.debounce(RelativeTime::milliseconds(100), scheduler), values);
+
+        subject.onNext(1);
+        clock.advanceBy(RelativeTime::milliseconds(50));
+        subject.onNext(2);
+        clock.advanceBy(RelativeTime::milliseconds(50));
+        CHECK(values.isEmpty());
+
+        clock.advanceBy(RelativeTime::milliseconds(50));
+        ReaX_RequireValues(values, 2);
+    }
+
+    IT("samples values in virtual time")
+    {
+        Array<int> values;
+        ReaX_CollectValues(subject.sample(RelativeTime::milliseconds(100), scheduler), values);
+
+        subject.onNext(1);
+        subject.onNext(2);
+        clock.advanceBy(RelativeTime::milliseconds(100));
+        ReaX_RequireValues(values, 2);
+
+        subject.onNext(3);
+        clock.advanceBy(RelativeTime::milliseconds(200));
+        ReaX_RequireValues(values, 2, 3);
+    }
+}
+
+TEST_CASE("Scheduler::getStats",
+          "[Scheduler][Scheduler::getStats]")
+{
+    IT("counts the values that are processed on the message thread")
+    {
+        const auto scheduler = Scheduler::messageThread();
+        const auto statsBefore = scheduler.getStats();
+
+        Array<int> values;
+        ReaX_CollectValues(Observable<int>::range(1, 100).observeOn(scheduler), values);
+        CHECK(scheduler.getStats().queueDepth > 0);
+
+        ReaX_RunDispatchLoopUntil(values.size() == 100);
+
+        const auto stats = scheduler.getStats();
+        REQUIRE(stats.numProcessed >= statsBefore.numProcessed + 100);
+        REQUIRE(stats.maxQueueDepth > 0);
+        REQUIRE(stats.maxItemsPerTick > 0);
+        REQUIRE(stats.averageItemsPerTick > 0);
+        REQUIRE(stats.medianLatency <= stats.latency95th);
+        REQUIRE(stats.latency95th <= stats.latency99th);
+        REQUIRE(stats.latency99th <= stats.maxLatency);
+    }
+
+    IT("counts the values that are processed on a background thread, if enabled")
+    {
+        ThreadOptions options;
+        options.collectStats = true;
+        const auto scheduler = Scheduler::backgroundThread(options);
+        const auto statsBefore = scheduler.getStats();
+
+        const auto values = Observable<int>::range(1, 100).observeOn(scheduler).toArray();
+
+        REQUIRE(values.size() == 100);
+        REQUIRE(scheduler.getStats().numProcessed >= statsBefore.numProcessed + 100);
+    }
+
+    IT("doesn't collect stats for threads by default")
+    {
+        const auto scheduler = Scheduler::newThread();
+        const auto values = Observable<int>::range(1, 100).observeOn(scheduler).toArray();
+
+        REQUIRE(values.size() == 100);
+        REQUIRE(scheduler.getStats().numProcessed == 0);
+    }
+
+    IT("doesn't collect stats for virtual time")
+    {
+        VirtualClock clock;
+        REQUIRE(Scheduler::virtualTime(clock).getStats().numProcessed == 0);
+    }
+
+    IT("emits stats periodically")
+    {
+        Array<uint64> numProcessed;
+        ReaX_CollectValues(Scheduler::messageThread().observeStats(RelativeTime::milliseconds(10)).map([](const SchedulerStats& stats) { return stats.numProcessed; }), numProcessed);
+
+        ReaX_RunDispatchLoopUntil(numProcessed.size() >= 3);
+
+        // The stats are emitted on the message thread, so each emission is counted by the next one
+        REQUIRE(numProcessed[2] > numProcessed[0]);
+    }
+}
+
+// Not run by default. Pass "[benchmark]" on the command line to compare the Schedulers.
+TEST_CASE("Scheduler benchmark",
+          "[Scheduler][.][benchmark]")
+{
+    const int numSubscriptions = 16;
+    const int numValues = 10000;
+
+    const auto measure = [&](const Scheduler& scheduler) {
+        std::atomic<int> numCompleted(0);
+        std::atomic<int64> sum(0);
+        DisposeBag disposeBag;
+
+        const auto startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numSubscriptions; ++i) {
+            Observable<int>::range(1, numValues).observeOn(scheduler).subscribe([&](int value) { sum += value; }, [](std::exception_ptr) {}, [&]() { ++numCompleted; }).disposedBy(disposeBag);
+        }
+
+        while (numCompleted < numSubscriptions)
+            Thread::yield();
+
+        CHECK(sum == int64(numSubscriptions) * numValues * (numValues + 1) / 2);
+
+        return Time::getMillisecondCounterHiRes() - startTime;
+    };
+
+    ThreadPool threadPool;
+
+    WARN("backgroundThread(): " << measure(Scheduler::backgroundThread()) << " ms");
+    WARN("fromThreadPool(): " << measure(Scheduler::fromThreadPool(threadPool)) << " ms");
+    WARN("threadPool(): " << measure(Scheduler::threadPool()) << " ms");
 }
@@ -40,6 +40,51 @@ TEST_CASE("Observer",
         REQUIRE(completed);
     }
 
+    IT("knows whether it is subscribed")
+    {
+        std::shared_ptr<Observer<int>> observer;
+        auto o = Observable<int>::create([&](Observer<int> o) {
+            observer = std::make_shared<Observer<int>>(o);
+        });
+
+        auto subscription = o.subscribe([](int) {});
+        CHECK(observer->isSubscribed());
+
+        subscription.unsubscribe();
+        REQUIRE_FALSE(observer->isSubscribed());
+    }
+
+    IT("calls the unsubscribe handler when the subscriber unsubscribes")
+    {
+        int numCalls = 0;
+        auto o = Observable<int>::create([&](Observer<int> observer) {
+            observer.addUnsubscribeHandler([&]() { numCalls++; });
+        });
+
+        auto subscription = o.subscribe([](int) {});
+        CHECK(numCalls == 0);
+
+        subscription.unsubscribe();
+        REQUIRE(numCalls == 1);
+    }
+
+    IT("stops a producer early when the subscriber has unsubscribed")
+    {
+        int numProduced = 0;
+        auto o = Observable<int>::create([&](Observer<int> observer) {
+            for (int i = 0; i < 1000 && observer.isSubscribed(); ++i) {
+                numProduced++;
+                observer.onNext(i);
+            }
+        });
+
+        Array<int> values;
+        ReaX_CollectValues(o.take(3), values);
+
+        ReaX_CheckValues(values, 0, 1, 2);
+        REQUIRE(numProduced == 3);
+    }
+
     IT("can subscribe to an Observable")
     {
         DisposeBag disposeBag;
@@ -111,6 +156,26 @@ TEST_CASE("Observer contravariance",
             
             ReaX_RequireValues(values, 15);
         }
+        
+        IT("converts values when subscribed to an Observable")
+        {
+            Array<var> values;
+            Observer<double> o = vars;
+            ReaX_CollectValues(vars, values);
+            Observable<int>::just(17).subscribe(o);
+            
+            ReaX_RequireValues(values, var(17.0));
+        }
+        
+        IT("passes values through when subscribed to an Observable of the same type")
+        {
+            Array<String> values;
+            Observer<String> o = strings;
+            ReaX_CollectValues(strings, values);
+            Observable<String>::just("Hello").subscribe(o);
+            
+            ReaX_RequireValues(values, "Hello");
+        }
     }
     
     CONTEXT("inheritance")
@@ -74,6 +74,36 @@ TEST_CASE("BehaviorSubject",
         BehaviorSubject<Point<int>> subject(Point<int>(13, 556));
         REQUIRE(subject.getValue() == Point<int>(13, 556));
     }
+
+    IT("returns consistent values while another thread is pushing values")
+    {
+        BehaviorSubject<Point<int>> points(Point<int>(0, 0));
+        BehaviorSubject<String> strings("0");
+        std::atomic<bool> done(false);
+
+        std::thread writer([&]() {
+            for (int i = 1; i <= 10000; ++i) {
+                points.onNext(Point<int>(i, -i));
+                strings.onNext(String(i));
+            }
+
+            done = true;
+        });
+
+        bool consistent = true;
+
+        while (!done) {
+            const auto point = points.getValue();
+            consistent &= (point.x == -point.y);
+            consistent &= strings.getValue().containsOnly("0123456789");
+        }
+
+        writer.join();
+
+        CHECK(consistent);
+        CHECK(points.getValue() == Point<int>(10000, -10000));
+        REQUIRE(strings.getValue() == "10000");
+    }
 }
 
 
@@ -133,6 +163,24 @@ TEST_CASE("PublishSubject",
         ReaX_RequireValues(values, 12345);
     }
 
+    IT("keeps emitting to other Observers when an Observer unsubscribes while being notified")
+    {
+        PublishSubject<int> subject;
+        Array<int> first, second;
+        std::unique_ptr<Subscription> subscription;
+        subscription.reset(new Subscription(subject.subscribe([&](int i) {
+            first.add(i);
+            subscription->unsubscribe();
+        })));
+        ReaX_CollectValues(subject, second);
+
+        subject.onNext(1);
+        subject.onNext(2);
+
+        ReaX_CheckValues(first, 1);
+        ReaX_RequireValues(second, 1, 2);
+    }
+
     IT("emits an error when calling onError")
     {
         PublishSubject<int> subject;
@@ -230,6 +278,46 @@ TEST_CASE("ReplaySubject",
         ReaX_RequireValues(values, 7, 28, 3, 6);
     }
 
+    IT("replays the most recent values in order after the buffer has wrapped around several times")
+    {
+        ReplaySubject<int> subject(3);
+
+        for (int i = 0; i < 11; ++i)
+            subject.onNext(i);
+
+        Array<int> values;
+        ReaX_CollectValues(subject, values);
+
+        ReaX_RequireValues(values, 8, 9, 10);
+    }
+
+    IT("only replays the values that were emitted within the time window")
+    {
+        ReplaySubject<int> subject(RelativeTime::milliseconds(50));
+        subject.onNext(1);
+        subject.onNext(2);
+        Thread::sleep(80);
+        subject.onNext(3);
+
+        Array<int> values;
+        ReaX_CollectValues(subject, values);
+
+        ReaX_RequireValues(values, 3);
+    }
+
+    IT("limits a time-windowed buffer by the max. buffer size")
+    {
+        ReplaySubject<int> subject(RelativeTime::seconds(10), 2);
+        subject.onNext(1);
+        subject.onNext(2);
+        subject.onNext(3);
+
+        Array<int> values;
+        ReaX_CollectValues(subject, values);
+
+        ReaX_RequireValues(values, 2, 3);
+    }
+
     IT("changes value when changing the Observer")
     {
         subject.onNext(32.51);
@@ -250,6 +338,39 @@ TEST_CASE("ReplaySubject",
         ReaX_RequireValues(values, 12345);
     }
 
+    IT("doesn't hold its lock while emitting")
+    {
+        ReplaySubject<int> subject;
+        Array<int> values;
+        subject.subscribe([&](int i) {
+            values.add(i);
+
+            // Would deadlock if the subject was locked while calling onNext
+            if (i == 1)
+                std::thread([&subject]() { subject.onNext(2); }).join();
+        }).disposedBy(disposeBag);
+
+        subject.onNext(1);
+
+        ReaX_RequireValues(values, 1, 2);
+    }
+
+    IT("emits values that are pushed from within onNext after the current one")
+    {
+        ReplaySubject<int> subject;
+        Array<int> values;
+        subject.subscribe([&](int i) {
+            if (i == 1)
+                subject.onNext(2);
+
+            values.add(i);
+        }).disposedBy(disposeBag);
+
+        subject.onNext(1);
+
+        ReaX_RequireValues(values, 1, 2);
+    }
+
     IT("emits an error when calling onError")
     {
         ReplaySubject<int> subject;
@@ -317,4 +438,67 @@ TEST_CASE("onNext move overload",
         REQUIRE(counters.numCopyAssignments == 0);
         REQUIRE(counters.numMoveAssignments == 0);
     }
+    
+    CONTEXT("subscribeMoving")
+    {
+        DisposeBag disposeBag;
+        auto keep = [](CopyAndMoveConstructible&& value) { CopyAndMoveConstructible kept(std::move(value)); };
+        
+        IT("moves an rvalue to the last subscriber")
+        {
+            subject.subscribe([](const CopyAndMoveConstructible&) {}).disposedBy(disposeBag);
+            subject.subscribeMoving(keep).disposedBy(disposeBag);
+            subject.onNext(CopyAndMoveConstructible(&counters));
+            
+            CHECK(counters.numCopyConstructions == 0);
+            REQUIRE(counters.numMoveConstructions == 3);
+        }
+        
+        IT("copies if another subscriber is notified afterwards")
+        {
+            subject.subscribeMoving(keep).disposedBy(disposeBag);
+            subject.subscribe([](const CopyAndMoveConstructible&) {}).disposedBy(disposeBag);
+            subject.onNext(CopyAndMoveConstructible(&counters));
+            
+            CHECK(counters.numCopyConstructions == 1);
+            REQUIRE(counters.numMoveConstructions == 2);
+        }
+        
+        IT("copies an lvalue, because it isn't given away")
+        {
+            subject.subscribeMoving(keep).disposedBy(disposeBag);
+            CopyAndMoveConstructible test(&counters);
+            subject.onNext(test);
+            
+            // Into the any, and out of the any
+            CHECK(counters.numCopyConstructions == 2);
+            REQUIRE(counters.numMoveConstructions == 1);
+        }
+        
+        IT("doesn't move the values of just out")
+        {
+            const auto observable = Observable<String>::just("x");
+            Array<String> values;
+            observable.subscribeMoving([&](String&& value) { values.add(std::move(value)); }).disposedBy(disposeBag);
+            observable.subscribeMoving([&](String&& value) { values.add(std::move(value)); }).disposedBy(disposeBag);
+            
+            ReaX_RequireValues(values, "x", "x");
+        }
+        
+        IT("doesn't move the values of repeat out")
+        {
+            Array<String> values;
+            Observable<String>::repeat("x", 3).subscribeMoving([&](String&& value) { values.add(std::move(value)); }).disposedBy(disposeBag);
+            
+            ReaX_RequireValues(values, "x", "x", "x");
+        }
+        
+        IT("doesn't move the accumulated value of scan out")
+        {
+            Array<String> values;
+            Observable<String>::from({ "a", "b", "c" }).scan(String(), [](const String& accumulated, const String& next) { return accumulated + next; }).subscribeMoving([&](String&& value) { values.add(std::move(value)); }).disposedBy(disposeBag);
+            
+            ReaX_RequireValues(values, "a", "ab", "abc");
+        }
+    }
 }
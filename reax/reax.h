@@ -37,6 +37,17 @@ END_JUCE_MODULE_DECLARATION
 #include <utility>
 #include <vector>
 
+// C++20 coroutine support (Generator, AsyncIterator and co_await for Observables)
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define REAX_HAS_COROUTINES 1
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <optional>
+#else
+#define REAX_HAS_COROUTINES 0
+#endif
+
 // Enable stricter warnings
 #include "util/internal/reax_ExtraWarnings.h"
 #pragma clang diagnostic push
@@ -47,6 +58,7 @@ namespace reax {
 typedef std::tuple<> Empty;
 
 #include "util/internal/reax_any.h"
+#include "util/internal/reax_RcuCell.h"
 #include "rx/reax_Subscription.h"
 #include "rx/reax_DisposeBag.h"
 #include "rx/internal/reax_Observer_Impl.h"
@@ -56,9 +68,11 @@ typedef std::tuple<> Empty;
 #include "rx/reax_Observable.h"
 #include "rx/internal/reax_Subjects_Impl.h"
 #include "rx/reax_Subjects.h"
+#include "rx/reax_Coroutines.h"
 
 #include "util/reax_LockFreeSource.h"
 #include "util/reax_LockFreeTarget.h"
+#include "util/reax_LockFreeBroadcast.h"
 
 #include "integration/reax_GUIExtensions.h"
 #include "integration/reax_ModelExtensions.h"
@@ -1,6 +1,12 @@
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
 
+#if JUCE_LINUX
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wcomma"
 #include "RxCpp/Rx/v2/src/rxcpp/rx.hpp"
@@ -15,14 +21,20 @@ namespace reax {
 using namespace juce;
 
 #include "util/internal/reax_any.h"
+#include "util/internal/reax_BoundedQueue.h"
+#include "util/internal/reax_RcuCell.h"
+#include "util/internal/reax_TimerWheel.h"
     
 #include "rx/reax_Subscription.h"
+#include "rx/internal/reax_Backpressure_Impl.h"
 #include "rx/internal/reax_Observable_Impl.h"
 #include "rx/reax_Scheduler.h"
 #include "rx/internal/reax_Observer_Impl.h"
 #include "rx/internal/reax_Scheduler_Impl.h"
 #include "rx/internal/reax_Subjects_Impl.h"
 #include "rx/reax_DisposeBag.h"
+#include "util/internal/reax_TimerWheel.cpp"
+#include "rx/internal/reax_Backpressure_Impl.cpp"
 #include "rx/reax_Subscription.cpp"
 #include "rx/reax_DisposeBag.cpp"
 #include "rx/reax_Scheduler.cpp"
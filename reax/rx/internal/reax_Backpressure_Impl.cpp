@@ -0,0 +1,137 @@
+namespace {
+// The subscription that Observable::subscribe is subscribing on this thread
+thread_local const rxcpp::composite_subscription* currentSubscription = nullptr;
+
+// The demands by subscription. An entry is only added when a backpressure operator subscribes, or when Subscription::request is called before that. It's removed when the subscription ends. Subscribing may happen on another thread (e.g. with subscribeOn), so the demand is found through the subscription rather than the current thread.
+class DemandRegistry
+{
+public:
+    typedef detail::DemandImpl::RequestHandler RequestHandler;
+
+    static DemandRegistry& getInstance()
+    {
+        static DemandRegistry registry;
+        return registry;
+    }
+
+    // Sets the handler, and takes the requests that were made before. Returns false if there's a handler already.
+    bool setHandler(const rxcpp::composite_subscription& subscription, const RequestHandler& requestHandler, uint64& pending)
+    {
+        bool isNew = false;
+
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+            auto& demand = findOrAdd(subscription, isNew);
+
+            if (demand.requestHandler)
+                return false;
+
+            demand.requestHandler = requestHandler;
+            pending = demand.pending;
+            demand.pending = 0;
+        }
+
+        if (isNew)
+            removeWhenUnsubscribed(subscription);
+
+        return true;
+    }
+
+    // Returns the handler. If there's none yet, it adds the request to the pending ones, and returns nullptr.
+    RequestHandler getHandlerOrAddPending(const rxcpp::composite_subscription& subscription, unsigned int numValues)
+    {
+        bool isNew = false;
+        RequestHandler requestHandler;
+
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+            auto& demand = findOrAdd(subscription, isNew);
+
+            if (demand.requestHandler)
+                requestHandler = demand.requestHandler;
+            else
+                demand.pending += numValues;
+        }
+
+        if (isNew)
+            removeWhenUnsubscribed(subscription);
+
+        return requestHandler;
+    }
+
+private:
+    struct Demand
+    {
+        RequestHandler requestHandler;
+        uint64 pending = 0;
+    };
+
+    SpinLock spinLock;
+    std::map<rxcpp::subscription, Demand> demands;
+
+    // Must be called with the lock held
+    Demand& findOrAdd(const rxcpp::composite_subscription& subscription, bool& isNew)
+    {
+        const rxcpp::subscription key(subscription);
+        const auto it = demands.find(key);
+
+        if (it != demands.end())
+            return it->second;
+
+        isNew = true;
+        return demands[key];
+    }
+
+    // Must be called without the lock: If the subscription has ended already, it removes the entry right away.
+    void removeWhenUnsubscribed(rxcpp::composite_subscription subscription)
+    {
+        const rxcpp::subscription key(subscription);
+
+        subscription.add([this, key]() {
+            const SpinLock::ScopedLockType lock(spinLock);
+            demands.erase(key);
+        });
+    }
+};
+}
+
+namespace detail {
+bool DemandImpl::claim(const rxcpp::composite_subscription& subscription, const RequestHandler& requestHandler)
+{
+    uint64 pending = 0;
+
+    if (!DemandRegistry::getInstance().setHandler(subscription, requestHandler, pending))
+        return false;
+
+    // Forward the requests that were made before the handler was registered
+    while (pending > 0) {
+        const auto numValues = static_cast<unsigned int>(jmin<uint64>(pending, std::numeric_limits<unsigned int>::max()));
+        requestHandler(numValues);
+        pending -= numValues;
+    }
+
+    return true;
+}
+
+void DemandImpl::request(const rxcpp::composite_subscription& subscription, unsigned int numValues)
+{
+    if (const auto requestHandler = DemandRegistry::getInstance().getHandlerOrAddPending(subscription, numValues))
+        requestHandler(numValues);
+}
+
+DemandImpl::ScopedSubscribe::ScopedSubscribe(const rxcpp::composite_subscription& subscription)
+: previous(currentSubscription)
+{
+    currentSubscription = &subscription;
+}
+
+DemandImpl::ScopedSubscribe::~ScopedSubscribe()
+{
+    currentSubscription = previous;
+}
+
+bool DemandImpl::isSubscribing(const rxcpp::composite_subscription& subscription)
+{
+    return (currentSubscription != nullptr && *currentSubscription == subscription);
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+namespace detail {
+// Connects Subscription::request to the backpressure operator (e.g. Observable::onBackpressureBuffer) that is closest to the subscriber. The operator registers its request handler for the subscriber's rxcpp subscription, and requests are looked up through the same subscription. So plain subscriptions, which neither have such an operator nor call request, don't pay anything.
+struct DemandImpl
+{
+    typedef std::function<void(unsigned int)> RequestHandler;
+
+    // Registers the handler for the given subscription, and forwards the requests that were made before. Returns false if a handler is registered already (i.e. another backpressure operator is closer to the subscriber).
+    static bool claim(const rxcpp::composite_subscription& subscription, const RequestHandler& requestHandler);
+
+    // Forwards the request to the handler that's registered for the given subscription. If there's none yet, the request is kept until a handler is registered.
+    static void request(const rxcpp::composite_subscription& subscription, unsigned int numValues);
+
+    // Marks the subscription that Observable::subscribe is subscribing on this thread, while it exists. It's only a thread-local pointer, so it doesn't cost anything.
+    class ScopedSubscribe
+    {
+    public:
+        explicit ScopedSubscribe(const rxcpp::composite_subscription& subscription);
+        ~ScopedSubscribe();
+
+    private:
+        const rxcpp::composite_subscription* const previous;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedSubscribe)
+    };
+
+    // Returns true if Observable::subscribe is subscribing with the given subscription on this thread. Then the requests of the returned Subscription reach whoever claims it.
+    static bool isSubscribing(const rxcpp::composite_subscription& subscription);
+};
+}
@@ -6,6 +6,19 @@ std::chrono::milliseconds durationFromRelativeTime(const juce::RelativeTime& rel
 
 const std::runtime_error InvalidRangeError("Invalid range.");
 using detail::any;
+using detail::SchedulerImpl;
+
+// The coordination that time-based operators and subscribeOn use to run actions on the given Scheduler
+rxcpp::identity_one_worker workerCoordination(const SchedulerImpl& scheduler)
+{
+    // Schedulers that can't run arbitrary actions (like Scheduler::realtime) can only be used with observeOn. In release builds, they fall back to the current thread.
+    if (!scheduler.scheduler) {
+        jassertfalse;
+        return rxcpp::identity_current_thread();
+    }
+
+    return rxcpp::identity_one_worker(*scheduler.scheduler);
+}
 
 // An Observable that holds a Value to keep receiving changes until the Observable is destroyed.
 class ValueObservable : private Value::Listener
@@ -39,6 +52,396 @@ private:
     const rxcpp::subjects::behavior<var> subject;
 };
 
+// Holds values from a source Observable until the subscriber requests them via Subscription::request. Values are emitted on the thread that calls onNext or request, but never concurrently.
+class BackpressureBuffer
+{
+public:
+    enum class Strategy {
+        Buffer,
+        Drop,
+        Latest
+    };
+
+    BackpressureBuffer(const rxcpp::subscriber<any>& subscriber, Strategy strategy, unsigned int capacity)
+    : subscriber(subscriber),
+      strategy(strategy),
+      capacity(capacity),
+      workInProgress(0)
+    {}
+
+    void onNext(const any& value)
+    {
+        {
+            const ScopedLock lock(criticalSection);
+
+            if (terminated)
+                return;
+
+            // Values in the queue that haven't been requested yet
+            const size_t numUnrequested = (queue.size() > requested ? queue.size() - static_cast<size_t>(requested) : 0);
+
+            // The new value can be emitted immediately
+            if (queue.size() < requested)
+                queue.push_back(value);
+            else {
+                switch (strategy) {
+                    case Strategy::Buffer:
+                        if (numUnrequested < capacity)
+                            queue.push_back(value);
+                        else {
+                            error = std::make_exception_ptr(std::runtime_error("Backpressure buffer overflow."));
+                            terminated = true;
+                        }
+                        break;
+
+                    case Strategy::Drop:
+                        break;
+
+                    case Strategy::Latest:
+                        if (numUnrequested > 0)
+                            queue.back() = value;
+                        else
+                            queue.push_back(value);
+                        break;
+                }
+            }
+        }
+
+        drain();
+    }
+
+    void onError(std::exception_ptr e)
+    {
+        {
+            const ScopedLock lock(criticalSection);
+            if (terminated)
+                return;
+
+            error = e;
+            terminated = true;
+        }
+
+        drain();
+    }
+
+    void onCompleted()
+    {
+        {
+            const ScopedLock lock(criticalSection);
+            terminated = true;
+        }
+
+        drain();
+    }
+
+    void request(unsigned int numValues)
+    {
+        {
+            const ScopedLock lock(criticalSection);
+            requested = jmin(requested + numValues, std::numeric_limits<uint64>::max() / 2);
+        }
+
+        drain();
+    }
+
+private:
+    const rxcpp::subscriber<any> subscriber;
+    const Strategy strategy;
+    const unsigned int capacity;
+
+    CriticalSection criticalSection;
+    std::deque<any> queue;
+    uint64 requested = 0;
+    bool terminated = false;
+    std::exception_ptr error;
+
+    // Only one thread drains at a time. Other threads just increment this, so the draining thread checks again.
+    std::atomic<int> workInProgress;
+    juce::Array<any> batch;
+
+    void drain()
+    {
+        if (workInProgress++ != 0)
+            return;
+
+        for (int missed = 1; missed != 0; missed = (workInProgress -= missed)) {
+            bool notifyCompleted = false;
+            std::exception_ptr notifyError;
+
+            {
+                const ScopedLock lock(criticalSection);
+
+                // An error is emitted immediately, dropping any buffered values
+                if (error) {
+                    notifyError = error;
+                    error = std::exception_ptr();
+                    queue.clear();
+                }
+
+                while (!queue.empty() && requested > 0) {
+                    batch.add(std::move(queue.front()));
+                    queue.pop_front();
+                    requested--;
+                }
+
+                notifyCompleted = (terminated && !notifyError && queue.empty() && batch.isEmpty());
+            }
+
+            if (notifyError) {
+                subscriber.on_error(notifyError);
+                return;
+            }
+
+            for (auto& value : batch)
+                subscriber.on_next(value);
+
+            batch.clearQuick();
+
+            if (notifyCompleted) {
+                subscriber.on_completed();
+                return;
+            }
+        }
+    }
+};
+
+// Base for the time-based operators that run on the shared TimerWheel. Values are delivered with the lock held, so they are never delivered concurrently or out of order.
+class TimedOperator : public std::enable_shared_from_this<TimedOperator>
+{
+public:
+    typedef detail::TimerWheel::Clock Clock;
+
+    TimedOperator(const rxcpp::subscriber<any>& subscriber, Clock::duration period)
+    : subscriber(subscriber),
+      period(period)
+    {}
+
+    virtual ~TimedOperator() {}
+
+    // Must be called once, right after construction
+    void start()
+    {
+        const std::weak_ptr<TimedOperator> weakThis = shared_from_this();
+        timer = std::make_shared<detail::TimerWheel::Timer>([weakThis]() {
+            if (auto self = weakThis.lock())
+                self->timerFired();
+        });
+
+        // The subscription keeps the operator alive. Unsubscribing removes the Timer from the wheel.
+        const auto self = shared_from_this();
+        subscriber.add(rxcpp::make_subscription([self]() {
+            detail::TimerWheel::getShared().cancel(self->timer);
+        }));
+
+        started();
+    }
+
+    virtual void onNext(const any& value)
+    {
+        const ScopedLock lock(criticalSection);
+        latestValue = value;
+        hasValue = true;
+    }
+
+    virtual void onError(std::exception_ptr error)
+    {
+        detail::TimerWheel::getShared().cancel(timer);
+
+        const ScopedLock lock(criticalSection);
+        hasValue = false;
+        subscriber.on_error(error);
+    }
+
+    virtual void onCompleted()
+    {
+        detail::TimerWheel::getShared().cancel(timer);
+
+        const ScopedLock lock(criticalSection);
+        hasValue = false;
+        subscriber.on_completed();
+    }
+
+protected:
+    const rxcpp::subscriber<any> subscriber;
+    const Clock::duration period;
+    std::shared_ptr<detail::TimerWheel::Timer> timer;
+    CriticalSection criticalSection;
+    any latestValue = any(0);
+    bool hasValue = false;
+
+    virtual void started() {}
+    virtual void timerFired() = 0;
+
+    // Must be called with the lock held
+    void emitLatestValue()
+    {
+        if (!hasValue)
+            return;
+
+        hasValue = false;
+        subscriber.on_next(latestValue);
+    }
+};
+
+// Observable::debounce: Each value reschedules the same Timer, which is O(1) and doesn't allocate.
+class Debouncer : public TimedOperator
+{
+public:
+    using TimedOperator::TimedOperator;
+
+    void onNext(const any& value) override
+    {
+        const ScopedLock lock(criticalSection);
+        latestValue = value;
+        hasValue = true;
+        dueTime = Clock::now() + period;
+        detail::TimerWheel::getShared().schedule(timer, dueTime);
+    }
+
+    void onCompleted() override
+    {
+        detail::TimerWheel::getShared().cancel(timer);
+
+        // The pending value is emitted right away
+        const ScopedLock lock(criticalSection);
+        emitLatestValue();
+        subscriber.on_completed();
+    }
+
+private:
+    Clock::time_point dueTime;
+
+    void timerFired() override
+    {
+        const ScopedLock lock(criticalSection);
+
+        // Another value has arrived while the Timer fired, or the Timer fired early. Make sure the value is emitted at dueTime.
+        if (Clock::now() < dueTime) {
+            detail::TimerWheel::getShared().schedule(timer, dueTime);
+            return;
+        }
+
+        emitLatestValue();
+    }
+};
+
+// Observable::sample: A periodic Timer emits the latest value, if there's a new one.
+class Sampler : public TimedOperator
+{
+public:
+    using TimedOperator::TimedOperator;
+
+private:
+    Clock::time_point nextTime;
+
+    void started() override
+    {
+        const ScopedLock lock(criticalSection);
+        nextTime = Clock::now() + period;
+        detail::TimerWheel::getShared().schedule(timer, nextTime);
+    }
+
+    void timerFired() override
+    {
+        const ScopedLock lock(criticalSection);
+
+        if (!subscriber.is_subscribed())
+            return;
+
+        emitLatestValue();
+
+        // Relative to the start time, so the period doesn't drift
+        nextTime += period;
+        detail::TimerWheel::getShared().schedule(timer, nextTime);
+    }
+};
+
+// Observable::interval: Emits 1, 2, 3, and so on, starting right away.
+class Ticker : public TimedOperator
+{
+public:
+    using TimedOperator::TimedOperator;
+
+private:
+    Clock::time_point nextTime;
+    long long nextValue = 1;
+
+    void started() override
+    {
+        const ScopedLock lock(criticalSection);
+        nextTime = Clock::now();
+        detail::TimerWheel::getShared().schedule(timer, nextTime);
+    }
+
+    void timerFired() override
+    {
+        const ScopedLock lock(criticalSection);
+
+        if (!subscriber.is_subscribed())
+            return;
+
+        subscriber.on_next(any(nextValue++));
+
+        nextTime += period;
+        detail::TimerWheel::getShared().schedule(timer, nextTime);
+    }
+};
+
+// Subscribes a TimedOperator of the given type to the source
+template<typename Operator>
+rxcpp::observable<any> _timed(const rxcpp::observable<any>& source, std::chrono::milliseconds period)
+{
+    return rxcpp::observable<>::create<any>([source, period](const rxcpp::subscriber<any>& subscriber) {
+        const auto timedOperator = std::make_shared<Operator>(subscriber, period);
+        timedOperator->start();
+
+        source.subscribe(subscriber.get_subscription(),
+                         [timedOperator](const any& value) { timedOperator->onNext(value); },
+                         [timedOperator](std::exception_ptr e) { timedOperator->onError(e); },
+                         [timedOperator]() { timedOperator->onCompleted(); });
+    });
+}
+
+// Holds the latest value for Observable::observeOnLatest. The producer replaces the value without locking.
+class LatestValueSlot
+{
+public:
+    // Replaces the held value. Returns true if the slot was empty. Only called by the producer.
+    bool store(const any& newValue)
+    {
+        slots[back] = newValue;
+
+        // Publish the written slot, and continue with the one that was in the middle
+        const auto previous = middle.exchange(back | dirtyBit, std::memory_order_acq_rel);
+        back = (previous & indexMask);
+
+        return ((previous & dirtyBit) == 0);
+    }
+
+    // Takes the held value out of the slot. Returns the fallback if the slot is empty. Only called by the consumer.
+    any take(const any& fallback)
+    {
+        if ((middle.load(std::memory_order_acquire) & dirtyBit) == 0)
+            return fallback;
+
+        // The producer may have published another value in the meantime. The slot is dirty either way.
+        const auto previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = (previous & indexMask);
+
+        return std::move(slots[front]);
+    }
+
+private:
+    static const int indexMask = 3;
+    static const int dirtyBit = 4;
+
+    // A triple buffer: The producer writes to the back slot, the consumer reads from the front slot, and they swap with the middle slot. So neither side allocates, locks or waits.
+    any slots[3] = { any(0), any(0), any(0) };
+    int front = 0;
+    int back = 2;
+    std::atomic<int> middle{ 1 };
+};
+
 using Function2 = std::function<any(const any&, const any&)>;
 using Function3 = std::function<any(const any&, const any&, const any&)>;
 using Function4 = std::function<any(const any&, const any&, const any&, const any&)>;
@@ -107,6 +510,32 @@ rxcpp::observable<any> _zip(const any& wrapped, Function&& function, Os&&... obs
 {
     return unwrap(wrapped).zip(function, unwrap(observables.wrapped)...);
 }
+
+rxcpp::observable<any> _onBackpressure(const any& wrapped, BackpressureBuffer::Strategy strategy, unsigned int capacity)
+{
+    const auto source = unwrap(wrapped);
+
+    return rxcpp::observable<>::create<any>([source, strategy, capacity](const rxcpp::subscriber<any>& subscriber) {
+        const auto buffer = std::make_shared<BackpressureBuffer>(subscriber, strategy, capacity);
+        const std::weak_ptr<BackpressureBuffer> weakBuffer(buffer);
+
+        const bool claimed = detail::DemandImpl::claim(subscriber.get_subscription(), [weakBuffer](unsigned int numValues) {
+            if (auto buffer = weakBuffer.lock())
+                buffer->request(numValues);
+        });
+
+        // If another backpressure operator is closer to the subscriber, it handles the requests. So just pass the values through.
+        if (!claimed) {
+            source.subscribe(subscriber);
+            return;
+        }
+
+        source.subscribe(subscriber.get_subscription(),
+                         [buffer](const any& value) { buffer->onNext(value); },
+                         [buffer](std::exception_ptr e) { buffer->onError(e); },
+                         [buffer]() { buffer->onCompleted(); });
+    });
+}
 }
 
 namespace detail {
@@ -153,8 +582,22 @@ ObservableImpl ObservableImpl::fromValue(Value value)
 
 ObservableImpl ObservableImpl::interval(const juce::RelativeTime& period)
 {
-    auto o = rxcpp::observable<>::interval(durationFromRelativeTime(period));
-    return wrap(o.map([](long long value) { return any(value); }));
+    const auto duration = durationFromRelativeTime(period);
+
+    return wrap(rxcpp::observable<>::create<any>([duration](const rxcpp::subscriber<any>& subscriber) {
+        std::make_shared<Ticker>(subscriber, duration)->start();
+    }));
+}
+
+ObservableImpl ObservableImpl::interval(const juce::RelativeTime& period, const SchedulerImpl& scheduler)
+{
+    const auto coordination = workerCoordination(scheduler);
+    const auto duration = durationFromRelativeTime(period);
+
+    // The first value is emitted at the time of subscription, as measured by the Scheduler's clock
+    return wrap(rxcpp::observable<>::defer([coordination, duration]() {
+        return rxcpp::observable<>::interval(coordination.now(), duration, coordination).map([](long long value) { return any(value); });
+    }));
 }
 
 ObservableImpl ObservableImpl::just(const any& value)
@@ -199,7 +642,9 @@ Subscription ObservableImpl::subscribe(const std::function<void(const any&)>& on
                                        const std::function<void(std::exception_ptr)>& onError,
                                        const std::function<void()>& onCompleted) const
 {
-    rxcpp::subscription subscription = unwrap(wrapped).subscribe(onNext, onError, onCompleted);
+    const rxcpp::composite_subscription subscription;
+    const detail::DemandImpl::ScopedSubscribe scopedSubscribe(subscription);
+    unwrap(wrapped).subscribe(subscription, onNext, onError, onCompleted);
 
     return Subscription(any(subscription));
 }
@@ -207,7 +652,8 @@ Subscription ObservableImpl::subscribe(const std::function<void(const any&)>& on
 Subscription ObservableImpl::subscribe(const ObserverImpl& observer) const
 {
     auto subscriber = observer.wrapped.get<rxcpp::subscriber<any>>();
-    rxcpp::subscription subscription = unwrap(wrapped).subscribe(subscriber);
+    const detail::DemandImpl::ScopedSubscribe scopedSubscribe(subscriber.get_subscription());
+    rxcpp::composite_subscription subscription = unwrap(wrapped).subscribe(subscriber);
 
     return Subscription(any(subscription));
 }
@@ -272,9 +718,29 @@ ObservableImpl ObservableImpl::concat(const Array<ObservableImpl>& others) const
     REAX_OBSERVABLE_IMPL_UNROLLED_LIST_IMPLEMENTATION(concat, others);
 }
 
+ObservableImpl ObservableImpl::concat(const Array<ObservableImpl>& others, const SchedulerImpl& scheduler) const
+{
+    // Each source is subscribed on the Scheduler. With Scheduler::trampoline, subscribing to the next source is queued until the previous one has returned, so the stack doesn't grow with the number of sources.
+    const auto coordination = workerCoordination(scheduler);
+
+    std::vector<rxcpp::observable<any>> sources;
+    sources.reserve(static_cast<size_t>(others.size()) + 1);
+    sources.push_back(unwrap(wrapped).subscribe_on(coordination).as_dynamic());
+
+    for (auto& other : others)
+        sources.push_back(unwrap(other.wrapped).subscribe_on(coordination).as_dynamic());
+
+    return wrap(rxcpp::observable<>::iterate(std::move(sources), rxcpp::identity_immediate()).concat());
+}
+
 ObservableImpl ObservableImpl::debounce(const juce::RelativeTime& period) const
 {
-    return wrap(unwrap(wrapped).debounce(durationFromRelativeTime(period)));
+    return wrap(_timed<Debouncer>(unwrap(wrapped), durationFromRelativeTime(period)));
+}
+
+ObservableImpl ObservableImpl::debounce(const juce::RelativeTime& period, const SchedulerImpl& scheduler) const
+{
+    return wrap(unwrap(wrapped).debounce(durationFromRelativeTime(period), workerCoordination(scheduler)));
 }
 
 ObservableImpl ObservableImpl::distinctUntilChanged(const std::function<bool(const any&, const any&)>& equals) const
@@ -293,6 +759,11 @@ ObservableImpl ObservableImpl::filter(const std::function<bool(const any&)>& pre
     return wrap(unwrap(wrapped).filter([predicate](const any& value) { return predicate(value); }));
 }
 
+ObservableImpl ObservableImpl::first() const
+{
+    return wrap(unwrap(wrapped).first());
+}
+
 ObservableImpl ObservableImpl::flatMap(const std::function<ObservableImpl(const any&)>& f) const
 {
     return wrap(unwrap(wrapped).flat_map([f](const any& value) {
@@ -300,15 +771,46 @@ ObservableImpl ObservableImpl::flatMap(const std::function<ObservableImpl(const
     }));
 }
 
+ObservableImpl ObservableImpl::flatMap(const std::function<ObservableImpl(const any&)>& f, const SchedulerImpl& scheduler) const
+{
+    // The returned Observables are subscribed on the Scheduler. With Scheduler::trampoline, that's queued until the current value has been processed.
+    const auto coordination = workerCoordination(scheduler);
+
+    return wrap(unwrap(wrapped).flat_map([f, coordination](const any& value) {
+        return unwrap(f(value).wrapped).subscribe_on(coordination);
+    }));
+}
+
 ObservableImpl ObservableImpl::map(const std::function<any(const any&)>& function) const
 {
     return wrap(unwrap(wrapped).map(function));
 }
 
+ObservableImpl ObservableImpl::map(any (*function)(const any&)) const
+{
+    // Stores the function pointer directly, without wrapping it in a std::function
+    return wrap(unwrap(wrapped).map(function));
+}
+
 ObservableImpl ObservableImpl::merge(const juce::Array<ObservableImpl>& others) const {
     REAX_OBSERVABLE_IMPL_UNROLLED_LIST_IMPLEMENTATION(merge, others)
 }
 
+ObservableImpl ObservableImpl::onBackpressureBuffer(unsigned int capacity) const
+{
+    return wrap(_onBackpressure(wrapped, BackpressureBuffer::Strategy::Buffer, capacity));
+}
+
+ObservableImpl ObservableImpl::onBackpressureDrop() const
+{
+    return wrap(_onBackpressure(wrapped, BackpressureBuffer::Strategy::Drop, 0));
+}
+
+ObservableImpl ObservableImpl::onBackpressureLatest() const
+{
+    return wrap(_onBackpressure(wrapped, BackpressureBuffer::Strategy::Latest, 0));
+}
+
 ObservableImpl ObservableImpl::reduce(const any& startValue, const std::function<any(const any&, const any&)>& f) const
 {
     return wrap(unwrap(wrapped).reduce(startValue, f));
@@ -316,7 +818,12 @@ ObservableImpl ObservableImpl::reduce(const any& startValue, const std::function
 
 ObservableImpl ObservableImpl::sample(const juce::RelativeTime& interval) const
 {
-    return wrap(unwrap(wrapped).sample_with_time(durationFromRelativeTime(interval)));
+    return wrap(_timed<Sampler>(unwrap(wrapped), durationFromRelativeTime(interval)));
+}
+
+ObservableImpl ObservableImpl::sample(const juce::RelativeTime& interval, const SchedulerImpl& scheduler) const
+{
+    return wrap(unwrap(wrapped).sample_with_time(durationFromRelativeTime(interval), workerCoordination(scheduler)));
 }
 
 ObservableImpl ObservableImpl::scan(const any& startValue, const std::function<any(const any&, const any&)>& f) const
@@ -386,12 +893,43 @@ ObservableImpl ObservableImpl::observeOn(const SchedulerImpl& scheduler) const
     return wrap(scheduler.schedule(unwrap(wrapped)));
 }
 
+ObservableImpl ObservableImpl::subscribeOn(const SchedulerImpl& scheduler) const
+{
+    return wrap(unwrap(wrapped).subscribe_on(workerCoordination(scheduler)));
+}
+
+ObservableImpl ObservableImpl::observeOnLatest(const SchedulerImpl& scheduler, const std::shared_ptr<std::atomic<uint64>>& numDroppedValues) const
+{
+    const auto source = unwrap(wrapped);
+    const auto schedule = scheduler.schedule;
+
+    return wrap(rxcpp::observable<>::defer([source, schedule, numDroppedValues]() {
+        // One slot per subscription
+        const auto slot = std::make_shared<LatestValueSlot>();
+
+        // Only a value that fills the empty slot is passed to the Scheduler. It just wakes up the consumer, which takes whatever is in the slot by then.
+        const auto wakeUps = source.filter([slot, numDroppedValues](const any& value) {
+            const bool wasEmpty = slot->store(value);
+
+            if (!wasEmpty)
+                numDroppedValues->fetch_add(1);
+
+            return wasEmpty;
+        });
+
+        return schedule(wakeUps).map([slot](const any& wakeUp) {
+            return slot->take(wakeUp);
+        });
+    }));
+}
+
 
 #pragma mark - Misc
 
-juce::Array<any> ObservableImpl::toArray(const std::function<void(std::exception_ptr)>& onError) const
+juce::Array<any> ObservableImpl::toArray(const std::function<void(std::exception_ptr)>& onError, int sizeHint) const
 {
     Array<any> values;
+    values.ensureStorageAllocated(sizeHint);
 
     unwrap(wrapped).as_blocking().subscribe([&](const any& value) {
         values.add(value);
@@ -401,6 +939,35 @@ juce::Array<any> ObservableImpl::toArray(const std::function<void(std::exception
     return values;
 }
 
+Subscription ObservableImpl::toArrayAsync(const SchedulerImpl& scheduler,
+                                          int sizeHint,
+                                          const std::function<void(const juce::Array<any>&)>& onCompleted,
+                                          const std::function<void(std::exception_ptr)>& onError) const
+{
+    typedef std::shared_ptr<Array<any>> Values;
+    const auto source = unwrap(wrapped);
+
+    // Collect into a new Array on each subscription
+    const auto collected = rxcpp::observable<>::defer([source, sizeHint]() {
+        const auto values = std::make_shared<Array<any>>();
+        values->ensureStorageAllocated(sizeHint);
+
+        return source.reduce(values, [](Values values, const any& value) {
+            values->add(value);
+            return values;
+        });
+    });
+
+    const auto scheduled = scheduler.schedule(collected.map([](const Values& values) { return any(values); }));
+
+    rxcpp::composite_subscription subscription = scheduled.subscribe([onCompleted](const any& values) {
+        onCompleted(*values.get<Values>());
+    },
+                                                           onError);
+
+    return Subscription(any(subscription));
+}
+
 void ObservableImpl::TerminateOnError(std::exception_ptr)
 {
     // error implicitly ignored, abort
@@ -18,6 +18,7 @@ struct ObservableImpl
     static ObservableImpl from(juce::Array<any>&& values);
     static ObservableImpl fromValue(juce::Value value);
     static ObservableImpl interval(const juce::RelativeTime& interval);
+    static ObservableImpl interval(const juce::RelativeTime& interval, const SchedulerImpl& scheduler);
     static ObservableImpl just(const any& value);
     static ObservableImpl never();
     static ObservableImpl integralRange(long long first, long long last, unsigned int step);
@@ -35,15 +36,24 @@ struct ObservableImpl
     // Operators
     ObservableImpl combineLatest(std::initializer_list<ObservableImpl> others, const any& function) const;
     ObservableImpl concat(const juce::Array<ObservableImpl>& others) const;
+    ObservableImpl concat(const juce::Array<ObservableImpl>& others, const SchedulerImpl& scheduler) const;
     ObservableImpl debounce(const juce::RelativeTime& interval) const;
+    ObservableImpl debounce(const juce::RelativeTime& interval, const SchedulerImpl& scheduler) const;
     ObservableImpl distinctUntilChanged(const std::function<bool(const any&, const any&)>& equals) const;
     ObservableImpl elementAt(int index) const;
     ObservableImpl filter(const std::function<bool(const any&)>& predicate) const;
+    ObservableImpl first() const;
     ObservableImpl flatMap(const std::function<ObservableImpl(const any&)>& function) const;
+    ObservableImpl flatMap(const std::function<ObservableImpl(const any&)>& function, const SchedulerImpl& scheduler) const;
     ObservableImpl map(const std::function<any(const any&)>& function) const;
+    ObservableImpl map(any (*function)(const any&)) const;
     ObservableImpl merge(const juce::Array<ObservableImpl>& others) const;
+    ObservableImpl onBackpressureBuffer(unsigned int capacity) const;
+    ObservableImpl onBackpressureDrop() const;
+    ObservableImpl onBackpressureLatest() const;
     ObservableImpl reduce(const any& startValue, const std::function<any(const any&, const any&)>& f) const;
     ObservableImpl sample(const juce::RelativeTime& interval) const;
+    ObservableImpl sample(const juce::RelativeTime& interval, const SchedulerImpl& scheduler) const;
     ObservableImpl scan(const any& startValue, const std::function<any(const any&, const any&)>& f) const;
     ObservableImpl skip(unsigned int numValues) const;
     ObservableImpl skipUntil(const ObservableImpl& other) const;
@@ -58,9 +68,15 @@ struct ObservableImpl
 
     // Scheduling
     ObservableImpl observeOn(const SchedulerImpl& scheduler) const;
+    ObservableImpl observeOnLatest(const SchedulerImpl& scheduler, const std::shared_ptr<std::atomic<juce::uint64>>& numDroppedValues) const;
+    ObservableImpl subscribeOn(const SchedulerImpl& scheduler) const;
 
     // Misc
-    juce::Array<any> toArray(const std::function<void(std::exception_ptr)>& onError) const;
+    juce::Array<any> toArray(const std::function<void(std::exception_ptr)>& onError, int sizeHint) const;
+    Subscription toArrayAsync(const SchedulerImpl& scheduler,
+                              int sizeHint,
+                              const std::function<void(const juce::Array<any>&)>& onCompleted,
+                              const std::function<void(std::exception_ptr)>& onError) const;
 
     // Default error/completion handlers
     [[ noreturn ]] static void TerminateOnError(std::exception_ptr);
@@ -17,4 +17,22 @@ void ObserverImpl::onCompleted() const
 {
     wrapped.get<rxcpp::subscriber<any>>().on_completed();
 }
+
+bool ObserverImpl::isSubscribed() const
+{
+    return wrapped.get<rxcpp::subscriber<any>>().is_subscribed();
+}
+
+void ObserverImpl::addUnsubscribeHandler(const std::function<void()>& handler) const
+{
+    wrapped.get<rxcpp::subscriber<any>>().add(rxcpp::make_subscription(handler));
+}
+
+bool ObserverImpl::claimDemand(const std::function<void(unsigned int)>& requestHandler) const
+{
+    const auto subscription = wrapped.get<rxcpp::subscriber<any>>().get_subscription();
+
+    // Only if the requests of a Subscription can reach this Observer (i.e. it's subscribed directly, not e.g. behind take or inside flatMap), and no backpressure operator handles them already
+    return (DemandImpl::isSubscribing(subscription) && DemandImpl::claim(subscription, requestHandler));
+}
 }
@@ -7,6 +7,9 @@ namespace detail {
         void onNext(any&& next) const;
         void onError(std::exception_ptr error) const;
         void onCompleted() const;
+        bool isSubscribed() const;
+        void addUnsubscribeHandler(const std::function<void()>& handler) const;
+        bool claimDemand(const std::function<void(unsigned int)>& requestHandler) const;
         
         const any wrapped;
     };
@@ -1,5 +1,363 @@
 namespace detail {
-SchedulerImpl::SchedulerImpl(const Schedule& schedule)
-: schedule(schedule)
+SchedulerImpl::SchedulerImpl(const Schedule& schedule, const std::shared_ptr<rxcpp::schedulers::scheduler>& scheduler, const std::shared_ptr<SchedulerStatsImpl>& stats)
+: schedule(schedule),
+  scheduler(scheduler),
+  stats(stats)
 {}
+
+#pragma mark - Stats
+
+namespace {
+    template<typename T>
+    void updateMaximum(std::atomic<T>& maximum, T value)
+    {
+        T current = maximum.load();
+        while (value > current && !maximum.compare_exchange_weak(current, value)) {}
+    }
+}
+
+SchedulerStatsImpl::SchedulerStatsImpl()
+{
+    for (auto& bucket : latencyBuckets)
+        bucket.store(0);
+}
+
+void SchedulerStatsImpl::onEnqueued()
+{
+    updateMaximum(maxQueueDepth, ++queueDepth);
+}
+
+void SchedulerStatsImpl::onRemoved(size_t numItems)
+{
+    queueDepth -= static_cast<int>(numItems);
+}
+
+void SchedulerStatsImpl::onProcessed(Clock::duration latency)
+{
+    --queueDepth;
+    ++numProcessed;
+
+    const auto microseconds = jmax<int64>(0, std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    updateMaximum(maxLatencyMicroseconds, microseconds);
+
+    int bucketIndex = 0;
+    while (bucketIndex < numLatencyBuckets - 1 && microseconds >= (int64(1) << bucketIndex))
+        ++bucketIndex;
+
+    ++latencyBuckets[bucketIndex];
+}
+
+void SchedulerStatsImpl::onTick(int numItems)
+{
+    ++numTicks;
+    numItemsInTicks += static_cast<uint64>(numItems);
+    updateMaximum(maxItemsPerTick, numItems);
+}
+
+SchedulerStats SchedulerStatsImpl::getStats() const
+{
+    SchedulerStats stats;
+    stats.queueDepth = jmax(0, queueDepth.load());
+    stats.maxQueueDepth = maxQueueDepth.load();
+    stats.numProcessed = numProcessed.load();
+
+    uint64 numLatencies = 0;
+    for (auto& bucket : latencyBuckets)
+        numLatencies += bucket.load();
+
+    const auto maxLatency = maxLatencyMicroseconds.load();
+    stats.maxLatency = RelativeTime(maxLatency / 1e6);
+    stats.medianLatency = getLatencyPercentile(0.5, numLatencies, maxLatency);
+    stats.latency95th = getLatencyPercentile(0.95, numLatencies, maxLatency);
+    stats.latency99th = getLatencyPercentile(0.99, numLatencies, maxLatency);
+
+    const auto ticks = numTicks.load();
+    stats.averageItemsPerTick = (ticks > 0 ? numItemsInTicks.load() / double(ticks) : 0.0);
+    stats.maxItemsPerTick = maxItemsPerTick.load();
+
+    return stats;
+}
+
+RelativeTime SchedulerStatsImpl::getLatencyPercentile(double percentile, uint64 numLatencies, int64 maxLatency) const
+{
+    if (numLatencies == 0)
+        return RelativeTime();
+
+    // Returns the upper bound of the bucket that contains the percentile, but never more than the maximum
+    const auto rank = static_cast<uint64>(std::ceil(static_cast<double>(numLatencies) * percentile));
+    uint64 numBelow = 0;
+
+    for (int i = 0; i < numLatencyBuckets - 1; ++i) {
+        numBelow += latencyBuckets[i].load();
+
+        if (numBelow >= rank)
+            return RelativeTime(jmin(int64(1) << i, maxLatency) / 1e6);
+    }
+
+    return RelativeTime(maxLatency / 1e6);
+}
+
+#pragma mark - Virtual Time
+
+namespace {
+    namespace rxsc = rxcpp::schedulers;
+
+    class VirtualWorker : public rxsc::worker_interface
+    {
+    public:
+        explicit VirtualWorker(const std::shared_ptr<VirtualClockImpl>& clock)
+        : clock(clock)
+        {}
+
+        clock_type::time_point now() const override { return clock->now(); }
+
+        void schedule(const rxsc::schedulable& scbl) const override
+        {
+            clock->schedule(clock->now(), scbl);
+        }
+
+        void schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const override
+        {
+            clock->schedule(when, scbl);
+        }
+
+    private:
+        const std::shared_ptr<VirtualClockImpl> clock;
+    };
+
+    class VirtualScheduler : public rxsc::scheduler_interface
+    {
+    public:
+        explicit VirtualScheduler(const std::shared_ptr<VirtualClockImpl>& clock)
+        : clock(clock)
+        {}
+
+        clock_type::time_point now() const override { return clock->now(); }
+
+        rxsc::worker create_worker(rxcpp::composite_subscription cs) const override
+        {
+            return rxsc::worker(cs, std::make_shared<VirtualWorker>(clock));
+        }
+
+    private:
+        const std::shared_ptr<VirtualClockImpl> clock;
+    };
+}
+
+VirtualClockImpl::VirtualClockImpl()
+: startTime(Clock::now()),
+  currentTime(startTime)
+{
+    // Recursive actions are rescheduled, so they run in the order of their due times
+    recursion.reset(false);
+}
+
+VirtualClockImpl::Clock::time_point VirtualClockImpl::now() const
+{
+    const ScopedLock lock(criticalSection);
+    return currentTime;
+}
+
+void VirtualClockImpl::schedule(Clock::time_point when, const rxcpp::schedulers::schedulable& what)
+{
+    const ScopedLock lock(criticalSection);
+    items.push(ScheduledItem{ when, nextSequenceNumber++, what });
+}
+
+void VirtualClockImpl::advanceBy(Clock::duration duration)
+{
+    const ScopedLock lock(criticalSection);
+    const auto targetTime = currentTime + duration;
+
+    while (!items.empty() && items.top().when <= targetTime) {
+        const auto item = items.top();
+        items.pop();
+
+        if (!item.what.is_subscribed())
+            continue;
+
+        currentTime = jmax(currentTime, item.when);
+
+        const ScopedUnlock unlock(criticalSection);
+        item.what(recursion.get_recurse());
+    }
+
+    currentTime = targetTime;
+}
+
+VirtualClockImpl::Clock::duration VirtualClockImpl::getElapsedTime() const
+{
+    const ScopedLock lock(criticalSection);
+    return currentTime - startTime;
+}
+
+rxcpp::schedulers::scheduler VirtualClockImpl::createScheduler()
+{
+    return rxsc::make_scheduler<VirtualScheduler>(shared_from_this());
+}
+
+#pragma mark - Realtime
+
+RealtimeDrainPointImpl::Target::Target(const rxcpp::subscriber<any>& subscriber)
+: subscriber(subscriber)
+{}
+
+RealtimeDrainPointImpl::RealtimeDrainPointImpl(size_t capacity)
+: pendingItems(capacity),
+  // Has room for more items, because it's only emptied from time to time
+  drainedCapacity(capacity * 2),
+  drainedItems(drainedCapacity)
+{}
+
+RealtimeDrainPointImpl::~RealtimeDrainPointImpl()
+{
+    stopTimer();
+}
+
+rxcpp::observable<any> RealtimeDrainPointImpl::schedule(const rxcpp::observable<any>& source)
+{
+    // The subscriptions must not keep the drain point alive, because the drained items would keep the subscriptions alive
+    const std::weak_ptr<RealtimeDrainPointImpl> weakThis = shared_from_this();
+
+    return rxcpp::observable<>::create<any>([weakThis, source](const rxcpp::subscriber<any>& subscriber) {
+        const auto target = std::make_shared<Target>(subscriber);
+
+        source.subscribe(subscriber.get_subscription(),
+                         [weakThis, target](const any& value) {
+                             if (auto drainPoint = weakThis.lock())
+                                 drainPoint->enqueue(target, value);
+                         },
+                         [weakThis, target](std::exception_ptr error) {
+                             if (auto drainPoint = weakThis.lock())
+                                 drainPoint->terminate(target, error);
+                         },
+                         [weakThis, target]() {
+                             if (auto drainPoint = weakThis.lock())
+                                 drainPoint->terminate(target, nullptr);
+                         });
+    });
+}
+
+void RealtimeDrainPointImpl::drain()
+{
+    // Must not allocate, lock or free memory from here on. Values are moved, so no reference counts change.
+    Item item;
+
+    // Reserve room in drainedItems before taking an item, so it never has to be destroyed here. If the drained items haven't been released yet, the remaining items stay pending until the next drain().
+    while (reserveDrainedSlot()) {
+        if (!pendingItems.tryDequeue(item)) {
+            numDrainedItems.fetch_sub(1);
+            return;
+        }
+
+        item.target->subscriber.on_next(item.value);
+        item.target->numDelivered.fetch_add(1);
+
+        const bool wasMoved = drainedItems.tryEnqueue(std::move(item));
+        jassert(wasMoved);
+        ignoreUnused(wasMoved);
+    }
+}
+
+bool RealtimeDrainPointImpl::reserveDrainedSlot()
+{
+    auto numItems = numDrainedItems.load();
+
+    do {
+        if (numItems >= drainedCapacity)
+            return false;
+    } while (!numDrainedItems.compare_exchange_weak(numItems, numItems + 1));
+
+    return true;
+}
+
+juce::uint64 RealtimeDrainPointImpl::getNumDroppedValues() const
+{
+    return numDroppedValues.load();
+}
+
+void RealtimeDrainPointImpl::enqueue(const std::shared_ptr<Target>& target, const any& value)
+{
+    releaseDrainedItems();
+
+    Item item;
+    item.target = target;
+    item.value = value;
+
+    if (pendingItems.tryEnqueue(std::move(item)))
+        target->numEnqueued.fetch_add(1);
+    else
+        // The queue is full. drain() isn't called often enough.
+        numDroppedValues.fetch_add(1);
+
+    startReleasing();
+}
+
+void RealtimeDrainPointImpl::terminate(const std::shared_ptr<Target>& target, std::exception_ptr error)
+{
+    {
+        const ScopedLock lock(criticalSection);
+        target->isCompleted = (error == nullptr);
+        target->error = error;
+        terminatedTargets.push_back(target);
+    }
+
+    startReleasing();
+}
+
+void RealtimeDrainPointImpl::releaseDrainedItems()
+{
+    // Someone else is already releasing them
+    const ScopedTryLock lock(criticalSection);
+    if (!lock.isLocked())
+        return;
+
+    // Each dequeued item destroys the previous one
+    Item item;
+    while (drainedItems.tryDequeue(item))
+        numDrainedItems.fetch_sub(1);
+}
+
+void RealtimeDrainPointImpl::startReleasing()
+{
+    if (isReleasing.load())
+        return;
+
+    const ScopedLock lock(criticalSection);
+    if (!isReleasing.exchange(true))
+        startTimer(10);
+}
+
+void RealtimeDrainPointImpl::timerCallback()
+{
+    releaseDrainedItems();
+
+    // Deliver onError/onCompleted for subscriptions whose values have all been drained
+    std::vector<std::shared_ptr<Target>> drainedTargets;
+    {
+        const ScopedLock lock(criticalSection);
+
+        for (auto it = terminatedTargets.begin(); it != terminatedTargets.end();) {
+            if ((*it)->numDelivered.load() == (*it)->numEnqueued.load()) {
+                drainedTargets.push_back(*it);
+                it = terminatedTargets.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    for (auto& target : drainedTargets) {
+        if (target->isCompleted)
+            target->subscriber.on_completed();
+        else
+            target->subscriber.on_error(target->error);
+    }
+
+    const ScopedLock lock(criticalSection);
+    if (terminatedTargets.empty() && pendingItems.isEmpty() && drainedItems.isEmpty()) {
+        isReleasing.store(false);
+        stopTimer();
+    }
+}
 }
@@ -1,12 +1,167 @@
 #pragma once
 
 namespace detail {
+/**
+ The counters behind Scheduler::getStats. They're atomic, so the dispatchers can update them without locking, and they can be read from any thread.
+ */
+class SchedulerStatsImpl
+{
+public:
+    typedef rxcpp::schedulers::scheduler_base::clock_type Clock;
+
+    SchedulerStatsImpl();
+
+    // Called when an item is queued
+    void onEnqueued();
+
+    // Called when items are removed from the queue without being processed, e.g. because they were unsubscribed
+    void onRemoved(size_t numItems = 1);
+
+    // Called when an item is taken from the queue to be processed. `latency` is the time since it was due.
+    void onProcessed(Clock::duration latency);
+
+    // Called when a dispatcher has processed `numItems` items at once (e.g. in one message)
+    void onTick(int numItems);
+
+    SchedulerStats getStats() const;
+
+private:
+    // Bucket i counts latencies of less than 2^i microseconds. The last bucket counts everything else.
+    static const int numLatencyBuckets = 32;
+
+    std::atomic<int> queueDepth{ 0 };
+    std::atomic<int> maxQueueDepth{ 0 };
+    std::atomic<juce::uint64> numProcessed{ 0 };
+    std::atomic<juce::int64> maxLatencyMicroseconds{ 0 };
+    std::atomic<juce::uint64> latencyBuckets[numLatencyBuckets];
+    std::atomic<juce::uint64> numTicks{ 0 };
+    std::atomic<juce::uint64> numItemsInTicks{ 0 };
+    std::atomic<int> maxItemsPerTick{ 0 };
+
+    juce::RelativeTime getLatencyPercentile(double percentile, juce::uint64 numLatencies, juce::int64 maxLatency) const;
+};
+
 struct SchedulerImpl
 {
     typedef std::function<rxcpp::observable<any>(const rxcpp::observable<any>&)> Schedule;
 
-    SchedulerImpl(const Schedule& schedule);
+    SchedulerImpl(const Schedule& schedule, const std::shared_ptr<rxcpp::schedulers::scheduler>& scheduler = nullptr, const std::shared_ptr<SchedulerStatsImpl>& stats = nullptr);
 
     const Schedule schedule;
+
+    // Used by time-based operators like debounce. May be nullptr, if the Scheduler doesn't support scheduling at a specific time.
+    const std::shared_ptr<rxcpp::schedulers::scheduler> scheduler;
+
+    // May be nullptr, if the Scheduler doesn't collect stats
+    const std::shared_ptr<SchedulerStatsImpl> stats;
+};
+
+// An action that's scheduled on one of the custom rx workers
+struct ScheduledItem
+{
+    rxcpp::schedulers::scheduler_base::clock_type::time_point when;
+    juce::uint64 sequenceNumber;
+    rxcpp::schedulers::schedulable what;
+
+    // Orders items by due time, and items with the same due time by the order in which they were scheduled
+    struct IsLater
+    {
+        bool operator()(const ScheduledItem& lhs, const ScheduledItem& rhs) const
+        {
+            if (lhs.when != rhs.when)
+                return (lhs.when > rhs.when);
+
+            return (lhs.sequenceNumber > rhs.sequenceNumber);
+        }
+    };
+};
+
+typedef std::priority_queue<ScheduledItem, std::vector<ScheduledItem>, ScheduledItem::IsLater> ScheduledItemQueue;
+
+/**
+ The clock behind a VirtualClock. Scheduled actions wait in a queue until the clock is advanced past their due time.
+ */
+class VirtualClockImpl : public std::enable_shared_from_this<VirtualClockImpl>
+{
+public:
+    typedef rxcpp::schedulers::scheduler_base::clock_type Clock;
+
+    VirtualClockImpl();
+
+    Clock::time_point now() const;
+
+    void schedule(Clock::time_point when, const rxcpp::schedulers::schedulable& what);
+
+    void advanceBy(Clock::duration duration);
+
+    Clock::duration getElapsedTime() const;
+
+    rxcpp::schedulers::scheduler createScheduler();
+
+private:
+    const Clock::time_point startTime;
+    const juce::CriticalSection criticalSection;
+    Clock::time_point currentTime;
+    ScheduledItemQueue items;
+    juce::uint64 nextSequenceNumber = 0;
+    rxcpp::schedulers::recursion recursion;
+};
+
+/**
+ The queue behind a RealtimeDrainPoint.
+ 
+ Values are moved into a preallocated BoundedQueue on the producer side. drain() moves them out on the realtime thread, delivers them, and moves them into a second queue, so they're destroyed on a non-realtime thread. drain() only takes an item if there's room for it in the second queue, so nothing is ever destroyed on the realtime thread. onError and onCompleted tear down the subscription, which frees memory, so they are delivered on the message thread once all values before them have been drained.
+ */
+class RealtimeDrainPointImpl : public std::enable_shared_from_this<RealtimeDrainPointImpl>, private juce::Timer
+{
+public:
+    explicit RealtimeDrainPointImpl(size_t capacity);
+    ~RealtimeDrainPointImpl();
+
+    rxcpp::observable<any> schedule(const rxcpp::observable<any>& source);
+
+    void drain();
+
+    juce::uint64 getNumDroppedValues() const;
+
+private:
+    // A subscription that's observed on the drain point
+    struct Target
+    {
+        explicit Target(const rxcpp::subscriber<any>& subscriber);
+
+        const rxcpp::subscriber<any> subscriber;
+        std::atomic<juce::uint64> numEnqueued{ 0 };
+        std::atomic<juce::uint64> numDelivered{ 0 };
+
+        // Set on the producer side when the source terminates
+        bool isCompleted = false;
+        std::exception_ptr error;
+    };
+
+    struct Item
+    {
+        std::shared_ptr<Target> target;
+        any value = any(0);
+    };
+
+    BoundedQueue<Item> pendingItems;
+    const size_t drainedCapacity;
+    BoundedQueue<Item> drainedItems;
+
+    // Items in drainedItems, plus the slots that drain() has reserved
+    std::atomic<size_t> numDrainedItems{ 0 };
+    std::atomic<juce::uint64> numDroppedValues{ 0 };
+
+    juce::CriticalSection criticalSection;
+    std::vector<std::shared_ptr<Target>> terminatedTargets;
+    std::atomic<bool> isReleasing{ false };
+
+    bool reserveDrainedSlot();
+    void enqueue(const std::shared_ptr<Target>& target, const any& value);
+    void terminate(const std::shared_ptr<Target>& target, std::exception_ptr error);
+    void releaseDrainedItems();
+    void startReleasing();
+    void timerCallback() override;
 };
 }
@@ -1,32 +1,348 @@
 namespace {
-template<typename SubjectType, typename... Args>
-detail::SubjectImpl MakeSubjectImpl(Args&&... args)
+// Wraps a subject that has onNext, onError, onCompleted and subscribe methods. The Observer and Observable own the subject.
+template<typename SubjectType>
+detail::SubjectImpl MakeSubjectImpl(const std::shared_ptr<SubjectType>& subject)
 {
-    // Need to use shared_ptr here, so we can call get_subscriber() and get_observable() on the same instance that we store in the SubjectImpl.
-    auto subject = std::make_shared<SubjectType>(std::forward<Args>(args)...);
-    return detail::SubjectImpl(any(subject), any(subject->get_subscriber().as_dynamic()), any(subject->get_observable().as_dynamic()));
+    // Takes the value by value, so it's only marked as movable (see any::markAsMovable) if it was passed as an rvalue
+    auto observer = rxcpp::make_subscriber<any>([subject](any value) { subject->onNext(std::move(value)); },
+                                                [subject](std::exception_ptr error) { subject->onError(error); },
+                                                [subject]() { subject->onCompleted(); });
+    auto observable = rxcpp::observable<>::create<any>([subject](const rxcpp::subscriber<any>& subscriber) {
+        subject->subscribe(subscriber);
+    });
+
+    return detail::SubjectImpl(any(subject), any(observer.as_dynamic()), any(observable.as_dynamic()));
 }
+
+/**
+ A subject that keeps its subscribers in an immutable array. onNext reads the current array without locking or allocating. Subscribing and unsubscribing copy the array and publish the copy.
+ */
+class CopyOnWriteSubject : public std::enable_shared_from_this<CopyOnWriteSubject>
+{
+public:
+    typedef std::vector<rxcpp::subscriber<any>> Subscribers;
+
+    void onNext(any value) const
+    {
+        subscribers.read([&value](const Subscribers& current) {
+            if (current.empty())
+                return;
+
+            // All but the last subscriber get a copy, which isn't movable and holds another reference. So they can't move the value out (see any::release).
+            {
+                const any sharedValue(value);
+
+                for (size_t i = 0; i + 1 < current.size(); ++i)
+                    current[i].on_next(sharedValue);
+            }
+
+            current.back().on_next(std::move(value));
+        });
+    }
+
+    void onError(std::exception_ptr exception) { terminate(exception, false); }
+
+    void onCompleted() { terminate(std::exception_ptr(), true); }
+
+    void subscribe(const rxcpp::subscriber<any>& subscriber)
+    {
+        {
+            const ScopedLock lock(criticalSection);
+
+            if (!isTerminated) {
+                auto copy = subscribers.get();
+                copy.push_back(subscriber);
+                subscribers.set(std::move(copy));
+
+                // Capture a weak_ptr, because the subscriber may outlive the subject
+                const std::weak_ptr<CopyOnWriteSubject> weakThis = shared_from_this();
+                const auto subscription = subscriber.get_subscription();
+                subscriber.add(rxcpp::make_subscription([weakThis, subscription]() {
+                    if (auto strongThis = weakThis.lock())
+                        strongThis->remove(subscription);
+                }));
+
+                return;
+            }
+        }
+
+        // Already terminated: Forward the terminal notification without holding the lock
+        if (isCompleted)
+            subscriber.on_completed();
+        else
+            subscriber.on_error(error);
+    }
+
+private:
+    CriticalSection criticalSection;
+    RcuCell<Subscribers> subscribers;
+    bool isTerminated = false;
+    bool isCompleted = false;
+    std::exception_ptr error;
+
+    void remove(const rxcpp::composite_subscription& subscription)
+    {
+        const ScopedLock lock(criticalSection);
+
+        auto copy = subscribers.get();
+        copy.erase(std::remove_if(copy.begin(), copy.end(), [&subscription](const rxcpp::subscriber<any>& subscriber) {
+                       return subscriber.get_subscription() == subscription;
+                   }),
+                   copy.end());
+        subscribers.set(std::move(copy));
+    }
+
+    void terminate(std::exception_ptr terminalError, bool completed)
+    {
+        Subscribers current;
+        {
+            const ScopedLock lock(criticalSection);
+
+            if (isTerminated)
+                return;
+
+            isTerminated = true;
+            isCompleted = completed;
+            error = terminalError;
+            current = subscribers.get();
+            subscribers.set(Subscribers());
+        }
+
+        for (auto& subscriber : current) {
+            if (completed)
+                subscriber.on_completed();
+            else
+                subscriber.on_error(terminalError);
+        }
+    }
+};
+
+/**
+ The values that a ReplaySubject remembers, in a contiguous ring.
+
+ If the buffer size is bounded, the ring is allocated upfront with exactly that many entries. Once it's full, the oldest value is overwritten, so adding a value doesn't allocate. If it's unbounded, the ring is a vector that grows as values are added.
+ */
+class ReplayBuffer
+{
+public:
+    explicit ReplayBuffer(size_t maxSize)
+    : maxSize(maxSize)
+    {
+        if (maxSize != std::numeric_limits<size_t>::max())
+            values.reserve(maxSize);
+    }
+
+    void add(const any& value)
+    {
+        if (values.size() < maxSize)
+            values.push_back(value);
+        else if (maxSize > 0) {
+            values[oldest] = value;
+            oldest = (oldest + 1) % maxSize;
+        }
+    }
+
+    /// Calls the function with each value, from oldest to newest. Stops early if the function returns false.
+    template<typename Function>
+    void forEach(Function&& function) const
+    {
+        const auto size = values.size();
+
+        for (size_t i = 0; i < size; ++i) {
+            if (!function(values[(oldest + i) % size]))
+                return;
+        }
+    }
+
+private:
+    const size_t maxSize;
+    std::vector<any> values;
+    size_t oldest = 0;
+};
+
+/**
+ The values that a time-windowed ReplaySubject remembers, with the time they were added.
+
+ Values that are older than the window are evicted lazily, when a value is added or the buffer is replayed. So the buffer only holds about as many values as are emitted within the window. A bounded maximum size limits it additionally.
+ */
+class TimedReplayBuffer
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    TimedReplayBuffer(Clock::duration window, size_t maxSize)
+    : window(window),
+      maxSize(maxSize)
+    {}
+
+    void add(const any& value)
+    {
+        const auto now = Clock::now();
+        evict(now);
+
+        if (maxSize == 0)
+            return;
+
+        if (entries.size() == maxSize)
+            entries.pop_front();
+
+        entries.emplace_back(now, value);
+    }
+
+    /// Evicts the values that are too old, and then calls the function with each remaining value, from oldest to newest. Stops early if the function returns false.
+    template<typename Function>
+    void forEach(Function&& function)
+    {
+        evict(Clock::now());
+
+        for (auto& entry : entries) {
+            if (!function(entry.second))
+                return;
+        }
+    }
+
+private:
+    const Clock::duration window;
+    const size_t maxSize;
+    std::deque<std::pair<Clock::time_point, any>> entries;
+
+    void evict(Clock::time_point now)
+    {
+        while (!entries.empty() && now - entries.front().first > window)
+            entries.pop_front();
+    }
+};
+
+/**
+ A subject that stores each value in a Buffer before emitting it, and replays the Buffer to new subscribers.
+
+ Storing a value, and taking a snapshot of the Buffer for a new subscriber, happen under a lock. Emitting and replaying happen outside of it, one at a time and in the same order. So a new subscriber receives each value exactly once, and observers may lock other things without risking a deadlock.
+ */
+template<typename Buffer>
+class ReplayingSubject
+{
+public:
+    explicit ReplayingSubject(Buffer&& buffer)
+    : buffer(std::move(buffer))
+    {}
+
+    void onNext(const any& value)
+    {
+        serialize([this, &value]() { buffer.add(value); },
+                  [this, value]() { subject->onNext(value); });
+    }
+
+    void onError(std::exception_ptr error)
+    {
+        serialize([]() {},
+                  [this, error]() { subject->onError(error); });
+    }
+
+    void onCompleted()
+    {
+        serialize([]() {},
+                  [this]() { subject->onCompleted(); });
+    }
+
+    void subscribe(const rxcpp::subscriber<any>& subscriber)
+    {
+        const auto values = std::make_shared<std::vector<any>>();
+
+        serialize([this, values]() {
+                      buffer.forEach([&values](const any& value) {
+                          values->push_back(value);
+                          return true;
+                      });
+                  },
+                  [this, values, subscriber]() {
+                      for (auto& value : *values) {
+                          if (!subscriber.is_subscribed())
+                              break;
+
+                          subscriber.on_next(value);
+                      }
+
+                      subject->subscribe(subscriber);
+                  });
+    }
+
+private:
+    CriticalSection criticalSection;
+    Buffer buffer;
+    const std::shared_ptr<CopyOnWriteSubject> subject = std::make_shared<CopyOnWriteSubject>();
+    std::deque<std::function<void()>> pendingEmissions;
+    bool isEmitting = false;
+
+    // Calls `prepare` under the lock, and then `emit` outside of it. If another call is emitting already (on another thread, or further up the stack), `emit` is queued, and that call runs it when it's done.
+    template<typename Prepare, typename Emit>
+    void serialize(Prepare&& prepare, Emit&& emit)
+    {
+        {
+            const ScopedLock lock(criticalSection);
+            prepare();
+
+            if (isEmitting) {
+                pendingEmissions.push_back(std::forward<Emit>(emit));
+                return;
+            }
+
+            isEmitting = true;
+        }
+
+        emit();
+
+        for (;;) {
+            std::function<void()> next;
+
+            {
+                const ScopedLock lock(criticalSection);
+
+                if (pendingEmissions.empty()) {
+                    isEmitting = false;
+                    return;
+                }
+
+                next = std::move(pendingEmissions.front());
+                pendingEmissions.pop_front();
+            }
+
+            next();
+        }
+    }
+};
 }
 
 namespace detail {
-SubjectImpl SubjectImpl::MakeBehaviorSubjectImpl(any&& initial)
+SubjectImpl SubjectImpl::MakeBehaviorSubjectImpl(any&& initial, const std::shared_ptr<ValueSnapshot>& snapshot)
 {
-    return MakeSubjectImpl<rxcpp::subjects::behavior<any>>(std::move(initial));
+    auto subject = std::make_shared<rxcpp::subjects::behavior<any>>(std::move(initial));
+    const auto subscriber = subject->get_subscriber();
+
+    // Update the snapshot before emitting, so observers see the new value when they call getValue()
+    auto observer = rxcpp::make_subscriber<any>([snapshot, subscriber](const any& value) {
+                                                    snapshot->store(value);
+                                                    subscriber.on_next(value);
+                                                },
+                                                [subscriber](std::exception_ptr error) { subscriber.on_error(error); },
+                                                [subscriber]() { subscriber.on_completed(); });
+
+    return SubjectImpl(any(subject), any(observer.as_dynamic()), any(subject->get_observable().as_dynamic()));
 }
 
 SubjectImpl SubjectImpl::MakePublishSubjectImpl()
 {
-    return MakeSubjectImpl<rxcpp::subjects::subject<any>>();
+    return MakeSubjectImpl(std::make_shared<CopyOnWriteSubject>());
 }
 
 SubjectImpl SubjectImpl::MakeReplaySubjectImpl(size_t bufferSize)
 {
-    return MakeSubjectImpl<rxcpp::subjects::replay<any, rxcpp::identity_one_worker>>(bufferSize, rxcpp::identity_immediate());
+    return MakeSubjectImpl(std::make_shared<ReplayingSubject<ReplayBuffer>>(ReplayBuffer(bufferSize)));
 }
 
-any SubjectImpl::getValue() const
+SubjectImpl SubjectImpl::MakeReplaySubjectImpl(const RelativeTime& window, size_t bufferSize)
 {
-    return wrapped.get<std::shared_ptr<rxcpp::subjects::behavior<any>>>()->get_value();
+    const auto duration = std::chrono::duration_cast<TimedReplayBuffer::Clock::duration>(std::chrono::duration<double>(window.inSeconds()));
+    return MakeSubjectImpl(std::make_shared<ReplayingSubject<TimedReplayBuffer>>(TimedReplayBuffer(duration, bufferSize)));
 }
 
 SubjectImpl::SubjectImpl(const any& subject, const any& observer, const any& observable)
@@ -1,13 +1,100 @@
 #pragma once
 
 namespace detail {
+/// Holds the most recent value of a BehaviorSubject, so it can be read without going through the subject.
+class ValueSnapshot
+{
+public:
+    virtual ~ValueSnapshot() {}
+
+    /// Called with each value that's pushed to the subject, before it's emitted.
+    virtual void store(const any& value) = 0;
+};
+
+/**
+ A ValueSnapshot for trivially copyable types, implemented as a seqlock.
+
+ The writer makes the sequence number odd while it's copying the value. Readers copy the value and retry if the sequence number was odd or has changed in the meantime. So reading is lock-free and doesn't allocate.
+ */
+template<typename T, bool = std::is_trivially_copyable<T>::value>
+class TypedValueSnapshot : public ValueSnapshot
+{
+public:
+    explicit TypedValueSnapshot(const T& initial)
+    {
+        std::memcpy(&storage, &initial, sizeof(T));
+    }
+
+    void store(const any& value) override
+    {
+        const T newValue = value.get<T>();
+        const juce::SpinLock::ScopedLockType lock(writeLock);
+
+        const auto sequenceNumber = sequence.load(std::memory_order_relaxed);
+        sequence.store(sequenceNumber + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&storage, &newValue, sizeof(T));
+        sequence.store(sequenceNumber + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        Storage copy;
+
+        for (;;) {
+            const auto sequenceNumber = sequence.load(std::memory_order_acquire);
+
+            if ((sequenceNumber & 1) == 0) {
+                std::memcpy(&copy, &storage, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence.load(std::memory_order_relaxed) == sequenceNumber)
+                    return *reinterpret_cast<const T*>(&copy);
+            }
+        }
+    }
+
+private:
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+
+    juce::SpinLock writeLock;
+    std::atomic<juce::uint32> sequence{ 0 };
+    Storage storage;
+};
+
+/**
+ A ValueSnapshot for other types. Each value is published as an immutable copy through an RcuCell, so reading is lock-free and doesn't allocate (except for copying the T that's returned).
+ */
+template<typename T>
+class TypedValueSnapshot<T, false> : public ValueSnapshot
+{
+public:
+    explicit TypedValueSnapshot(const T& initial)
+    : cell(initial)
+    {}
+
+    void store(const any& value) override
+    {
+        const juce::SpinLock::ScopedLockType lock(writeLock);
+        cell.set(value.get<T>());
+    }
+
+    T load() const
+    {
+        return cell.get();
+    }
+
+private:
+    juce::SpinLock writeLock;
+    RcuCell<T> cell;
+};
+
 struct SubjectImpl : public ObserverImpl, public ObservableImpl
 {
-    static SubjectImpl MakeBehaviorSubjectImpl(any&& initial);
+    static SubjectImpl MakeBehaviorSubjectImpl(any&& initial, const std::shared_ptr<ValueSnapshot>& snapshot);
     static SubjectImpl MakePublishSubjectImpl();
     static SubjectImpl MakeReplaySubjectImpl(size_t bufferSize);
-
-    any getValue() const;
+    static SubjectImpl MakeReplaySubjectImpl(const juce::RelativeTime& window, size_t bufferSize);
 
     explicit SubjectImpl(const any& subject, const any& observer, const any& observable);
     
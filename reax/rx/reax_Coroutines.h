@@ -0,0 +1,428 @@
+#pragma once
+
+#if REAX_HAS_COROUTINES
+
+/**
+ A coroutine that produces values lazily using `co_yield`. Use it with Observable::fromGenerator.
+ 
+ For example:
+ 
+     Generator<File> findFiles(File directory)
+     {
+         for (DirectoryIterator it(directory, true); it.next();)
+             co_yield it.getFile();
+     }
+ 
+ The coroutine only runs until the next `co_yield`, and is resumed when the next value is needed.
+ 
+ Only available when compiling with C++20 coroutine support.
+ */
+template<typename T>
+class Generator
+{
+public:
+    ///@cond INTERNAL
+    struct promise_type
+    {
+        Generator<T> get_return_object()
+        {
+            return Generator<T>(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // The yielded value lives until the coroutine is resumed, so it doesn't need to be copied here
+        std::suspend_always yield_value(const T& value) noexcept
+        {
+            current = std::addressof(value);
+            return {};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception()
+        {
+            exception = std::current_exception();
+        }
+
+        const T* current = nullptr;
+        std::exception_ptr exception;
+    };
+    ///@endcond
+
+    /// Move constructor.
+    Generator(Generator&& other) noexcept
+    : handle(std::exchange(other.handle, nullptr))
+    {}
+
+    /// Destroys the coroutine, if it hasn't run to completion.
+    ~Generator()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    /**
+     Resumes the coroutine until it yields the next value. Returns `false` if the coroutine has finished instead.
+     
+     If the coroutine has thrown an exception, it is rethrown here.
+     */
+    bool next()
+    {
+        handle.resume();
+
+        if (handle.promise().exception)
+            std::rethrow_exception(handle.promise().exception);
+
+        return !handle.done();
+    }
+
+    /// The value that was yielded last. Only valid after next() has returned `true`.
+    const T& getValue() const
+    {
+        return *handle.promise().current;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit Generator(std::coroutine_handle<promise_type> handle)
+    : handle(handle)
+    {}
+
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+};
+
+
+///@cond INTERNAL
+namespace detail {
+// Resumes a Generator once for each requested value, and emits the values to an Observer
+template<typename T>
+class GeneratorProducer
+{
+public:
+    static constexpr juce::uint64 Unbounded = std::numeric_limits<juce::uint64>::max();
+
+    GeneratorProducer(Generator<T>&& generator, const Observer<T>& observer)
+    : generator(std::move(generator)),
+      observer(observer)
+    {}
+
+    // Produces the requested values on the calling thread. If it's called while values are produced (e.g. from onNext, or from another thread), it only adds to the demand.
+    void request(juce::uint64 numValues)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex);
+            requested = (numValues > Unbounded - requested ? Unbounded : requested + numValues);
+
+            if (isProducing)
+                return;
+
+            isProducing = true;
+        }
+
+        while (true) {
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+
+                if (finished || requested == 0) {
+                    isProducing = false;
+                    return;
+                }
+
+                if (requested != Unbounded)
+                    requested--;
+            }
+
+            if (!produceNext()) {
+                const std::lock_guard<std::mutex> lock(mutex);
+                finished = true;
+                isProducing = false;
+                return;
+            }
+        }
+    }
+
+private:
+    Generator<T> generator;
+    const Observer<T> observer;
+    std::mutex mutex;
+    juce::uint64 requested = 0;
+    bool isProducing = false;
+    bool finished = false;
+
+    // Returns false if there are no more values
+    bool produceNext()
+    {
+        try {
+            // Don't resume the generator if nobody is interested in the next value anymore
+            if (!observer.isSubscribed())
+                return false;
+
+            if (generator.next()) {
+                observer.onNext(generator.getValue());
+                return true;
+            }
+        }
+        catch (...) {
+            observer.onError(std::current_exception());
+            return false;
+        }
+
+        observer.onCompleted();
+        return false;
+    }
+};
+}
+///@endcond
+
+template<typename T>
+Observable<T> Observable<T>::fromGenerator(const std::function<Generator<T>()>& factory)
+{
+    return Observable<T>::create([factory](const Observer<T>& observer) {
+        const auto producer = std::make_shared<detail::GeneratorProducer<T>>(factory(), observer);
+
+        // If nothing can request values from this subscriber (e.g. because it's behind take, or a backpressure operator handles the requests), produce until the generator finishes or the subscriber unsubscribes
+        if (!observer.impl.claimDemand([producer](unsigned int numValues) { producer->request(numValues); }))
+            producer->request(detail::GeneratorProducer<T>::Unbounded);
+    });
+}
+
+
+///@cond INTERNAL
+namespace detail {
+// Awaits the first value emitted by an Observable
+template<typename T>
+class ObservableAwaiter
+{
+public:
+    explicit ObservableAwaiter(const Observable<T>& observable)
+    : observable(observable),
+      state(std::make_shared<State>())
+    {}
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        state->handle = handle;
+        const auto state = this->state;
+
+        subscription = std::make_unique<Subscription>(observable.take(1).subscribe([state](const T& value) {
+            state->value.emplace(value);
+        },
+                                                                                   [state](std::exception_ptr error) {
+                                                                                       state->error = error;
+                                                                                       state->finish();
+                                                                                   },
+                                                                                   [state]() {
+                                                                                       state->finish();
+                                                                                   }));
+
+        // If the Observable has already finished synchronously, don't suspend at all
+        return !state->finished.exchange(true);
+    }
+
+    T await_resume()
+    {
+        if (state->error)
+            std::rethrow_exception(state->error);
+
+        if (!state->value)
+            throw std::runtime_error("Observable completed without emitting a value.");
+
+        return std::move(*state->value);
+    }
+
+private:
+    struct State
+    {
+        // Called on termination. The second of await_suspend and finish() resumes the coroutine.
+        void finish()
+        {
+            if (finished.exchange(true))
+                handle.resume();
+        }
+
+        std::coroutine_handle<> handle;
+        std::optional<T> value;
+        std::exception_ptr error;
+        std::atomic<bool> finished{ false };
+    };
+
+    const Observable<T> observable;
+    const std::shared_ptr<State> state;
+    std::unique_ptr<Subscription> subscription;
+};
+}
+///@endcond
+
+/**
+ Suspends the coroutine until the Observable emits its first value, and returns that value:
+ 
+     String text = co_await label.rx.text.first();
+ 
+ If the Observable notifies `onError`, the error is rethrown. If it completes without emitting a value, a `std::runtime_error` is thrown.
+ 
+ The coroutine is resumed on the thread that emitted the value. Use Observable::observeOn if it should continue on a specific thread. Unlike Observable::toArray, this never blocks a thread, so it can be used on the message thread.
+ 
+ Only available when compiling with C++20 coroutine support.
+ */
+template<typename T>
+detail::ObservableAwaiter<T> operator co_await(const Observable<T>& observable)
+{
+    return detail::ObservableAwaiter<T>(observable);
+}
+
+
+/**
+ Lets a coroutine iterate over the values emitted by an Observable, without blocking a thread:
+ 
+     AsyncIterator<String> lines(loadLines());
+ 
+     while (auto line = co_await lines.next())
+         parse(*line);
+ 
+ The Observable is subscribed when the AsyncIterator is created, and unsubscribed when it is destroyed. Values that are emitted while the coroutine isn't waiting are buffered.
+ 
+ The coroutine is resumed on the thread that emitted the value. Use Observable::observeOn if it should continue on a specific thread.
+ 
+ Only available when compiling with C++20 coroutine support.
+ */
+template<typename T>
+class AsyncIterator
+{
+    struct State;
+
+public:
+    /// Creates a new instance, and subscribes to the given Observable.
+    explicit AsyncIterator(const Observable<T>& observable)
+    : state(std::make_shared<State>())
+    {
+        const auto state = this->state;
+
+        subscription = std::make_unique<Subscription>(observable.subscribe([state](const T& value) {
+            state->push(value);
+        },
+                                                                           [state](std::exception_ptr error) {
+                                                                               state->finish(error);
+                                                                           },
+                                                                           [state]() {
+                                                                               state->finish(nullptr);
+                                                                           }));
+    }
+
+    /// Unsubscribes from the Observable.
+    ~AsyncIterator()
+    {
+        subscription->unsubscribe();
+    }
+
+    ///@cond INTERNAL
+    class NextAwaiter
+    {
+    public:
+        explicit NextAwaiter(const std::shared_ptr<State>& state)
+        : state(state)
+        {}
+
+        bool await_ready() const
+        {
+            const std::lock_guard<std::mutex> lock(state->mutex);
+            return (!state->values.empty() || state->finished);
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            const std::lock_guard<std::mutex> lock(state->mutex);
+
+            // A value may have arrived since await_ready
+            if (!state->values.empty() || state->finished)
+                return false;
+
+            state->waiting = handle;
+            return true;
+        }
+
+        std::optional<T> await_resume()
+        {
+            const std::lock_guard<std::mutex> lock(state->mutex);
+
+            if (!state->values.empty()) {
+                std::optional<T> value(std::move(state->values.front()));
+                state->values.pop_front();
+                return value;
+            }
+
+            if (state->error)
+                std::rethrow_exception(state->error);
+
+            return std::nullopt;
+        }
+
+    private:
+        const std::shared_ptr<State> state;
+    };
+    ///@endcond
+
+    /**
+     Suspends the coroutine until the Observable emits the next value, and returns it. Returns an empty `std::optional` when the Observable has completed.
+     
+     If the Observable notifies `onError`, the error is rethrown (after all values emitted before the error have been returned).
+     */
+    NextAwaiter next()
+    {
+        return NextAwaiter(state);
+    }
+
+private:
+    struct State
+    {
+        void push(const T& value)
+        {
+            resume([&]() { values.push_back(value); });
+        }
+
+        void finish(std::exception_ptr e)
+        {
+            resume([&]() {
+                error = e;
+                finished = true;
+            });
+        }
+
+        // Updates the state, and resumes the waiting coroutine (if any) after releasing the lock
+        template<typename Update>
+        void resume(Update&& update)
+        {
+            std::coroutine_handle<> handle;
+
+            {
+                const std::lock_guard<std::mutex> lock(mutex);
+                update();
+                std::swap(handle, waiting);
+            }
+
+            if (handle)
+                handle.resume();
+        }
+
+        std::mutex mutex;
+        std::deque<T> values;
+        bool finished = false;
+        std::exception_ptr error;
+        std::coroutine_handle<> waiting;
+    };
+
+    const std::shared_ptr<State> state;
+    std::unique_ptr<Subscription> subscription;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AsyncIterator)
+};
+
+#endif
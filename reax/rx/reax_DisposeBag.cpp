@@ -8,5 +8,5 @@ DisposeBag::~DisposeBag()
 
 void DisposeBag::insert(const Subscription& subscription)
 {
-    wrapped.get<rxcpp::composite_subscription>().add(subscription.wrapped.get<rxcpp::subscription>());
+    wrapped.get<rxcpp::composite_subscription>().add(subscription.wrapped.get<rxcpp::composite_subscription>());
 }
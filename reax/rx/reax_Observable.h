@@ -3,6 +3,11 @@
 template<typename T>
 class Observer;
 
+#if REAX_HAS_COROUTINES
+template<typename T>
+class Generator;
+#endif
+
 /**
  An Observable emits values over time.
  
@@ -100,6 +105,26 @@ public:
         return Impl::from(std::move(values));
     }
 
+#if REAX_HAS_COROUTINES
+    /**
+     Creates an Observable that emits the values yielded by a Generator coroutine. The `factory` is called on each new subscription, to create a new Generator.
+     
+     The values are produced on demand: When you subscribe directly (or only through operators like `map` and `filter`), the Generator is only resumed for the values you request, on the thread that calls Subscription::request:
+     
+         auto subscription = Observable<File>::fromGenerator([directory]() { return findFiles(directory); }).subscribe(addFile);
+         subscription.request(3); // Runs the coroutine until it has yielded 3 values
+     
+     ​ **Otherwise, the Generator runs eagerly** on the thread that subscribes, inside the `subscribe()` call, until it finishes or the subscriber unsubscribes. This is the case behind operators that subscribe on their own (like `take`, `first` or `flatMap`), and when a backpressure operator handles the requests. So there, an infinite Generator must be limited (e.g. with `take` or `takeWhile`), otherwise `subscribe()` never returns. For example, this only runs the coroutine until it has yielded 3 values:
+     
+         Observable<File>::fromGenerator([directory]() { return findFiles(directory); }).take(3)
+     
+     If the coroutine throws an exception, the Observable notifies onError.
+     
+     Only available when compiling with C++20 coroutine support.
+     */
+    static Observable<T> fromGenerator(const std::function<Generator<T>()>& factory);
+#endif
+
     /**
      Creates an Observable from a given JUCE Value. The returned Observable **only emits values until it is destroyed**, so you are responsible for managing its lifetime. Or use Reactive<Value>, which will handle this.
      
@@ -118,7 +143,7 @@ public:
      
      The Observable emits endlessly, but you can use Observable::take to get a finite number of values (for example).
      
-     The interval has millisecond resolution.
+     The interval has millisecond resolution. The values are emitted on a timer thread that's shared by all time-based operators.
      */
     template<typename U = T>
     static Observable<T> interval(const juce::RelativeTime& interval, typename std::enable_if<std::is_same<U, T>::value && std::is_same<int, T>::value>::type* = 0)
@@ -126,6 +151,15 @@ public:
         return Impl::interval(interval);
     }
 
+    /**
+     Like the other Observable::interval, but waits on the given Scheduler, and emits the values there. Use Scheduler::virtualTime to test code that uses an interval.
+     */
+    template<typename U = T>
+    static Observable<T> interval(const juce::RelativeTime& interval, const Scheduler& scheduler, typename std::enable_if<std::is_same<U, T>::value && std::is_same<int, T>::value>::type* = 0)
+    {
+        return Impl::interval(interval, *scheduler.impl);
+    }
+
     /**
      Creates an Observable which emits a single value.
      
@@ -219,6 +253,22 @@ public:
                               onCompleted);
     }
 
+    /**
+     Like the other Observable::subscribe, but passes each value as an rvalue, so `onNext` can keep it by moving it (e.g. into a queue).
+     
+     The value is only moved if its emitter has given it away: It must have been passed as an rvalue to a PublishSubject's (or an Observer's) onNext, this must be the last subscriber that the Subject notifies, and no operator may keep a copy of it. Otherwise, `onNext` gets a copy. So values from Observable::just, Observable::repeat, Observable::scan etc. are always copied.
+     */
+    Subscription subscribeMoving(const std::function<void(T&&)>& onNext,
+                                 const std::function<void(std::exception_ptr)>& onError = Impl::TerminateOnError,
+                                 const std::function<void()>& onCompleted = Impl::EmptyOnCompleted) const
+    {
+        return impl.subscribe([onNext](const any& next) {
+            onNext(next.release<T>());
+        },
+                              onError,
+                              onCompleted);
+    }
+
     /**
      Subscribes an Observer to an Observable. The Observer is notified whenever the Observable emits a value, or notifies `onError` / `onCompleted`.
      
@@ -227,12 +277,19 @@ public:
     template<typename U>
     Subscription subscribe(const Observer<U>& observer, typename std::enable_if<std::is_convertible<T, U>::value>::type* = 0) const
     {
-        // Converts values from T to U
-        static auto convert = [](const any& t) {
-            return toAny<U>(t.get<T>());
-        };
+        // The Observer converts values itself (it's an Observer<V> that was converted to Observer<U>). Convert from T to U and then to V in one step.
+        if (auto convert = observer.convert) {
+            return impl.map([convert](const any& t) {
+                           return convert(static_cast<U>(t.get<T>()));
+                       })
+                .subscribe(observer.impl);
+        }
 
-        return impl.map(convert).subscribe(observer.impl);
+        // No conversion needed, e.g. from float to double
+        if (any::has_same_representation<T, U>::value)
+            return impl.subscribe(observer.impl);
+
+        return impl.map(&Observable<U>::template convertFrom<T>).subscribe(observer.impl);
     }
         ///@}
 
@@ -286,18 +343,44 @@ public:
         return impl.concat(otherImpls);
     }
 
+    /**
+     Like the other Observable::concat, but subscribes to each Observable on the given Scheduler. There's no limit on the number of Observables.
+     
+     Use Scheduler::trampoline to concatenate many Observables that emit synchronously (like Observable::from or Observable::range), without growing the stack with each one:
+     
+         Observable<int>::just(0).concat(chunks, Scheduler::trampoline());
+     */
+    Observable<T> concat(const juce::Array<Observable<T>>& others, const Scheduler& scheduler) const
+    {
+        juce::Array<Impl> otherImpls;
+        otherImpls.ensureStorageAllocated(others.size());
+
+        for (auto& other : others)
+            otherImpls.add(other.impl);
+
+        return impl.concat(otherImpls, *scheduler.impl);
+    }
+
     /**
      Returns an Observable which emits if `interval` has passed without this Observable emitting a value. The returned Observable emits the latest value from this Observable.
      
      For example, think of the instant search in a search engine: Search suggestions are only loaded if the user hasn't pressed a key for a short period of time.
      
-     The `interval` has millisecond resolution.
+     The `interval` has millisecond resolution. The values are emitted on a timer thread that's shared by all time-based operators, unless this Observable completes first.
      */
     Observable<T> debounce(const juce::RelativeTime& interval) const
     {
         return impl.debounce(interval);
     }
 
+    /**
+     Like the other Observable::debounce, but waits on the given Scheduler, and emits the values there.
+     */
+    Observable<T> debounce(const juce::RelativeTime& interval, const Scheduler& scheduler) const
+    {
+        return impl.debounce(interval, *scheduler.impl);
+    }
+
     /**
      Returns an Observable which emits the same values as this Observable, but suppresses consecutive duplicate values.
      
@@ -334,6 +417,16 @@ public:
         });
     }
 
+    /**
+     Returns an Observable that emits only the first value emitted by this Observable, and then completes.
+     
+     If this Observable completes without emitting a value, the returned Observable notifies onError.
+     */
+    Observable<T> first() const
+    {
+        return impl.first();
+    }
+
     /**
      For each emitted value, calls `f` and subscribes to the Observable returned from `f`. The emitted values from all these returned Observables are *merged* (so they interleave).
      
@@ -355,6 +448,20 @@ public:
         });
     }
 
+    /**
+     Like the other Observable::flatMap, but subscribes to the Observables returned from `function` on the given Scheduler.
+     
+     With Scheduler::trampoline, recursive flatMaps run in a loop instead of nesting deeper with each level.
+     */
+    template<typename Function>
+    Observable<typename CallResult<Function, T>::ValueType> flatMap(Function&& function, const Scheduler& scheduler, typename std::enable_if<IsObservable<CallResult<Function, T>>::value>::type* = 0) const
+    {
+        return impl.flatMap([function](const any& value) {
+            return function(value.get<T>()).impl;
+        },
+                            *scheduler.impl);
+    }
+
     /**
      For each value emitted by this Observable, call the function with that value and emit the result.
      
@@ -388,6 +495,39 @@ public:
         return impl.merge(otherImpls);
     }
 
+    ///@{
+    /**
+     Returns an Observable that only emits as many values as the subscriber has requested via Subscription::request. This lets a slow subscriber (e.g. on the message thread) control how fast it receives values.
+     
+     Initially, no values are requested. So you must call Subscription::request on the Subscription returned from `subscribe()`:
+     
+         auto subscription = source.onBackpressureLatest().subscribe([](float level) { ... });
+         subscription.request(1); // Call again when ready for the next value
+     
+     Values that are emitted by this Observable while nothing is requested are handled differently, depending on the operator:
+     
+     - **onBackpressureBuffer** buffers up to `capacity` values and emits them when they are requested. If the buffer overflows, the returned Observable notifies `onError`.
+     - **onBackpressureDrop** drops them.
+     - **onBackpressureLatest** keeps only the latest one, and emits it when the next value is requested.
+     
+     Requests are handled by the backpressure operator closest to the subscriber. They only reach it through the subscriber of the Subscription, so use it as one of the last operators before `subscribe()`: After operators that subscribe on their own (like `take` or `flatMap`), nothing is requested from it.
+     */
+    Observable<T> onBackpressureBuffer(unsigned int capacity) const
+    {
+        return impl.onBackpressureBuffer(capacity);
+    }
+    /// \overload
+    Observable<T> onBackpressureDrop() const
+    {
+        return impl.onBackpressureDrop();
+    }
+    /// \overload
+    Observable<T> onBackpressureLatest() const
+    {
+        return impl.onBackpressureLatest();
+    }
+    ///@}
+
     /**
      Begins with a `startValue`, and then applies `f` to all values emitted by this Observable, and returns the aggregate result as a single-element Observable sequence.
      */
@@ -403,13 +543,21 @@ public:
      
      For example, this is useful when an Observable emits values very rapidly, but you only want to update a GUI component 25 times per second to reduce CPU load.
      
-     The interval has millisecond resolution.
+     The interval has millisecond resolution. The values are emitted on a timer thread that's shared by all time-based operators.
      */
     Observable<T> sample(const juce::RelativeTime& interval) const
     {
         return impl.sample(interval);
     }
 
+    /**
+     Like the other Observable::sample, but checks on the given Scheduler, and emits the values there.
+     */
+    Observable<T> sample(const juce::RelativeTime& interval, const Scheduler& scheduler) const
+    {
+        return impl.sample(interval, *scheduler.impl);
+    }
+
     /**
      Calls a function `f` with the given `startValue` and the first value emitted by this Observable. The value returned from `f` is remembered. When the second value is emitted, `f` is called with the remembered value (called the *accumulator*) and the second emitted value. The returned value is remembered, until the third value is emitted, and so on.
      
@@ -574,13 +722,49 @@ public:
              .observeOn(Scheduler::messageThread())
              .subscribe([&](double squareRoot) { }); // This lambda is called on the message thread
      
-     @see Scheduler::messageThread, Scheduler::backgroundThread and Scheduler::newThread
+     @see Scheduler::messageThread, Scheduler::backgroundThread and Scheduler::newThread, Observable::observeOnLatest
      */
     Observable<T> observeOn(const Scheduler& scheduler) const
     {
         return impl.observeOn(*scheduler.impl);
     }
 
+    /**
+     Like observeOn, but only delivers the latest value: If the Observable emits several values before the Scheduler gets around to processing them, only the most recent one is delivered. The others are dropped, and counted in `dropCounter`.
+     
+     This is useful if an Observable emits much more often than the subscriber needs, e.g. a level meter that's updated from the audio thread, but only painted once per frame:
+     
+         DropCounter dropCounter;
+         levels.observeOnLatest(Scheduler::messageThread(), dropCounter).subscribe([this](float level) {
+             meter.setLevel(level);
+         });
+     
+     Each subscription has a single slot for the latest value. Emitting a value replaces it without locking. onError and onCompleted are delivered after the latest value.
+     */
+    Observable<T> observeOnLatest(const Scheduler& scheduler, const DropCounter& dropCounter = DropCounter()) const
+    {
+        return impl.observeOnLatest(*scheduler.impl, dropCounter.numDroppedValues);
+    }
+
+    /**
+     Returns an Observable that subscribes to this Observable on the specified scheduler. Any work that happens on subscription (e.g. in the function passed to Observable::create or Observable::defer) runs there, instead of on the thread that calls subscribe. Unsubscribing happens on the scheduler, too.
+     
+     This is useful if setting up a source is expensive, and shouldn't block the message thread:
+     
+         Observable<File>::create([](Observer<File> observer) { ... }) // Scans a directory on a background thread
+             .subscribeOn(Scheduler::backgroundThread())
+             .observeOn(Scheduler::messageThread())
+             .subscribe([this](const File& file) { addToList(file); });
+     
+     In contrast to observeOn, the position of subscribeOn in a chain of operators doesn't matter. Scheduler::realtime can't be used with subscribeOn.
+     
+     @see Observable::observeOn
+     */
+    Observable<T> subscribeOn(const Scheduler& scheduler) const
+    {
+        return impl.subscribeOn(*scheduler.impl);
+    }
+
 
 #pragma mark - Misc
     /**
@@ -588,22 +772,63 @@ public:
      
      Be careful when you use this on the message thread: If the Observable needs to process something *asynchronously* on the message thread, calling this will deadlock.
      
+     If you know roughly how many values the Observable emits, pass a `sizeHint`. The storage for this many values is allocated upfront, so it doesn't need to be re-allocated while collecting.
+     
      ​ **If you don't pass an `onError` handler, an exception inside the Observable will terminate your app.**
+     
+     @see Observable::toArrayAsync
      */
     juce::Array<T> toArray(const std::function<void(std::exception_ptr)>& onError = Impl::TerminateOnError) const
     {
-        juce::Array<T> values;
-
-        for (const any& v : impl.toArray(onError))
-            values.add(v.get<T>());
+        return toArray(0, onError);
+    }
+    /// \overload
+    juce::Array<T> toArray(int sizeHint, const std::function<void(std::exception_ptr)>& onError = Impl::TerminateOnError) const
+    {
+        return fromAnyArray(impl.toArray(onError, sizeHint));
+    }
 
-        return values;
+    /**
+     Collects all values emitted by this Observable, without blocking. When the Observable has completed, `onCompleted` is called on the given `scheduler` with an Array of all emitted values.
+     
+     Unlike Observable::toArray, this can be used on the message thread, even if the Observable processes something asynchronously on the message thread:
+     
+         files.toArrayAsync(Scheduler::messageThread(), [this](const Array<File>& allFiles) {
+             fileList.setFiles(allFiles);
+         }).disposedBy(disposeBag);
+     
+     If you know roughly how many values the Observable emits, pass a `sizeHint`. The storage for this many values is allocated upfront, so it doesn't need to be re-allocated while collecting.
+     
+     The returned Subscription can be used to stop collecting values. `onCompleted` is not called in this case.
+     
+     ​ **If you don't pass an `onError` handler, an exception inside the Observable will terminate your app.**
+     */
+    Subscription toArrayAsync(const Scheduler& scheduler,
+                              const std::function<void(const juce::Array<T>&)>& onCompleted,
+                              const std::function<void(std::exception_ptr)>& onError = Impl::TerminateOnError) const
+    {
+        return toArrayAsync(scheduler, 0, onCompleted, onError);
+    }
+    /// \overload
+    Subscription toArrayAsync(const Scheduler& scheduler,
+                              int sizeHint,
+                              const std::function<void(const juce::Array<T>&)>& onCompleted,
+                              const std::function<void(std::exception_ptr)>& onError = Impl::TerminateOnError) const
+    {
+        return impl.toArrayAsync(*scheduler.impl, sizeHint, [onCompleted](const juce::Array<any>& values) {
+            onCompleted(fromAnyArray(values));
+        },
+                                 onError);
     }
 
-    /// Covariant constructor: If `U` is convertible to `T`, then an `Observable<U>` is convertible to an `Observable<T>`.
+    /**
+     Covariant constructor: If `U` is convertible to `T`, then an `Observable<U>` is convertible to an `Observable<T>`.
+     
+     If no conversion is needed (e.g. from float to double), the returned Observable shares the source with `other`. Otherwise it converts each value in a single map step.
+     */
     template<typename U>
     Observable(const Observable<U>& other, typename std::enable_if<std::is_convertible<U, T>::value>::type* = 0)
-    : Observable(other.impl.map([](const any& u) { return toAny(static_cast<T>(u.get<U>())); }))
+    : Observable(any::has_same_representation<U, T>::value ? other.impl : other.impl.map(&Observable<T>::convertFrom<U>))
     {}
 
 private:
@@ -630,6 +855,24 @@ private:
         return any(u.impl);
     }
 
+    // Converts a value that holds a U into one that holds a T
+    template<typename U>
+    static any convertFrom(const any& u)
+    {
+        return toAny(static_cast<T>(u.get<U>()));
+    }
+
+    static juce::Array<T> fromAnyArray(const juce::Array<any>& anyValues)
+    {
+        juce::Array<T> values;
+        values.ensureStorageAllocated(anyValues.size());
+
+        for (const any& v : anyValues)
+            values.add(v.get<T>());
+
+        return values;
+    }
+
     // any_args<Ts...>::type is a parameter pack with the same length as Ts, where all types are any.
     template<typename>
     struct any_args
@@ -639,3 +882,12 @@ private:
 
     JUCE_LEAK_DETECTOR(Observable)
 };
+
+// Defined here, because it needs the Observable class
+inline Observable<SchedulerStats> Scheduler::observeStats(const juce::RelativeTime& interval) const
+{
+    const Scheduler scheduler(*this);
+    return Observable<int>::interval(interval, Scheduler::messageThread()).map([scheduler](int) {
+        return scheduler.getStats();
+    });
+}
@@ -15,12 +15,20 @@ public:
     /// Notifies the Observer with a new value.
     void onNext(const T& value) const
     {
-        impl.onNext(convert ? convert(detail::any(value)) : detail::any(value));
+        impl.onNext(convert ? convert(value) : detail::any(value));
     }
     
     void onNext(T&& value) const
     {
-        impl.onNext(convert ? convert(detail::any(std::move(value))) : detail::any(std::move(value)));
+        if (convert) {
+            impl.onNext(convert(value));
+            return;
+        }
+
+        // The caller gives the value away, so a subscriber may move it out (see Observable::subscribeMoving)
+        detail::any movableValue(std::move(value));
+        movableValue.markAsMovable();
+        impl.onNext(std::move(movableValue));
     }
     ///@}
 
@@ -36,10 +44,48 @@ public:
         impl.onCompleted();
     }
 
-    /// Contravariant constructor: If T is convertible to U, an Observer<U> is convertible to an Observer<T>. 
+    /**
+     Returns `true` while someone is interested in the values pushed to this Observer. Returns `false` after the subscriber has unsubscribed, or after onError or onCompleted has been called.
+     
+     Long-running producers in Observable::create can check this to stop working early:
+     
+         Observable<Image>::create([files](Observer<Image> observer) {
+             for (auto& file : files) {
+                 if (!observer.isSubscribed())
+                     return;
+     
+                 observer.onNext(renderThumbnail(file));
+             }
+             observer.onCompleted();
+         });
+     
+     May be called from any thread.
+     */
+    bool isSubscribed() const
+    {
+        return impl.isSubscribed();
+    }
+
+    /**
+     Adds a function that's called when the subscriber unsubscribes, or when onError or onCompleted is called. Use it to cancel work that's running asynchronously, e.g. to stop a background Thread or close a file.
+     
+     If the Observer is not subscribed anymore, the function is called immediately.
+     
+     The function is called on the thread that unsubscribes, so it must be thread-safe.
+     */
+    void addUnsubscribeHandler(const std::function<void()>& handler) const
+    {
+        impl.addUnsubscribeHandler(handler);
+    }
+
+    /**
+     Contravariant constructor: If T is convertible to U, an Observer<U> is convertible to an Observer<T>.
+     
+     The conversion is chosen at compile time. If no conversion is needed (e.g. from float to double), the values are passed through as they are.
+     */
     template<typename U>
     Observer(const Observer<U>& other, typename std::enable_if<std::is_convertible<T, U>::value>::type* = 0)
-    : Observer(other.impl, [](const detail::any& value){ return detail::any(static_cast<U>(value.get<T>())); })
+    : Observer(other.impl, (detail::any::has_same_representation<T, U>::value ? nullptr : &convertTo<U>))
     {}
 
 protected:
@@ -47,7 +93,10 @@ protected:
     friend class Observable;
     
     ///@cond INTERNAL
-    Observer(const detail::ObserverImpl& impl, const std::function<detail::any(const detail::any&)>& convert = nullptr)
+    // Boxes a T into an any that holds a different type
+    typedef detail::any (*Convert)(const T&);
+
+    Observer(const detail::ObserverImpl& impl, Convert convert = nullptr)
     : impl(impl),
       convert(convert)
     {}
@@ -58,7 +107,13 @@ private:
     friend class Observer;
 
     const detail::ObserverImpl impl;
-    const std::function<detail::any(const detail::any&)> convert;
+    const Convert convert;
+
+    template<typename U>
+    static detail::any convertTo(const T& value)
+    {
+        return detail::any(static_cast<U>(value));
+    }
 
     JUCE_LEAK_DETECTOR(Observer)
 };
@@ -1,77 +1,1037 @@
 namespace {
     using namespace juce;
+    namespace rxsc = rxcpp::schedulers;
+    typedef rxsc::scheduler_base::clock_type Clock;
 
-    // A Rx dispatcher for the JUCE message thread. It processes Observables that are observed on it.
-    class JUCEDispatcher : private Timer
+#pragma mark - Message Thread
+
+    /**
+     A Rx dispatcher for the JUCE message thread. It processes Observables that are observed on it.
+     
+     It doesn't poll: When an item is scheduled that is due before everything else in the queue, it posts a single (coalesced) message to the message thread. Items that are due in the future arm a one-shot Timer. So the message thread isn't woken up while the queue is empty.
+     
+     Each worker (i.e. each subscription that is observed on the message thread) has its own queue. The queues are drained round-robin, one item at a time, so a busy Observable can't starve the others. Draining stops when the time budget is used up, and continues in the next message, so the message thread can handle painting and mouse events in between.
+     
+     There's one lane of queues per Scheduler::Priority. Lanes are strictly prioritized: A due item in a higher priority lane is always dispatched first, so lower priority lanes only get the rest of the time budget.
+     */
+    class JUCEDispatcher : private AsyncUpdater, private Timer
     {
     public:
         JUCEDispatcher()
-        : runLoop(createRunLoop())
+        : timeBudget(std::chrono::duration_cast<Clock::duration>(std::chrono::milliseconds(4)).count()),
+          nextDispatchTime(Clock::time_point::max()),
+          schedulers{ rxsc::make_scheduler<MessageThreadScheduler>(*this, 0, false),
+                      rxsc::make_scheduler<MessageThreadScheduler>(*this, 1, false),
+                      rxsc::make_scheduler<MessageThreadScheduler>(*this, 2, false) },
+          inlineSchedulers{ rxsc::make_scheduler<MessageThreadScheduler>(*this, 0, true),
+                            rxsc::make_scheduler<MessageThreadScheduler>(*this, 1, true),
+                            rxsc::make_scheduler<MessageThreadScheduler>(*this, 2, true) }
+        {
+            // Recursive actions are always rescheduled, instead of looping inline. Otherwise they would bypass the round-robin and the time budget.
+            recursion.reset(false);
+        }
+
+        ~JUCEDispatcher()
         {
-            // The run loop didn't get initialized! Please report this as a bug.
-            jassert(runLoop);
+            cancelPendingUpdate();
+        }
 
-            startTimerHz(60);
+        rxsc::scheduler getScheduler(Scheduler::Priority priority, Scheduler::Delivery delivery) const
+        {
+            const int laneIndex = static_cast<int>(priority);
+            return (delivery == Scheduler::Delivery::InlineIfIdle ? inlineSchedulers[laneIndex] : schedulers[laneIndex]);
         }
 
-        rxcpp::observe_on_one_worker createWorker() const
+        // Returns the stats of all priorities together
+        std::shared_ptr<detail::SchedulerStatsImpl> getStats() const
         {
-            return rxcpp::observe_on_run_loop(*runLoop);
+            return stats;
+        }
+
+        void setTimeBudget(const RelativeTime& budget)
+        {
+            const auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(jmax(0.0, budget.inSeconds())));
+            timeBudget.store(duration.count());
         }
 
     private:
-        typedef ScopedPointer<rxcpp::schedulers::run_loop> RunLoop_ptr;
-        const RunLoop_ptr runLoop;
+        const std::shared_ptr<detail::SchedulerStatsImpl> stats = std::make_shared<detail::SchedulerStatsImpl>();
+
+        // The items of a single worker. Guarded by the dispatcher's lock.
+        struct WorkerQueue
+        {
+            explicit WorkerQueue(int laneIndex)
+            : laneIndex(laneIndex)
+            {}
 
-        static RunLoop_ptr createRunLoop()
+            const int laneIndex;
+            detail::ScheduledItemQueue items;
+            bool isActive = false;
+
+            // True while one of the items is running
+            bool isRunning = false;
+        };
+
+        // The queues of one priority, which have items
+        struct Lane
+        {
+            std::vector<std::shared_ptr<WorkerQueue>> queues;
+            size_t nextQueueIndex = 0;
+        };
+
+        static const int numLanes = 3;
+
+        class MessageThreadWorker : public rxsc::worker_interface
         {
-            // Create the run loop on the message thread:
-            RunLoop_ptr rl;
-            static const auto create = [](void* rl) {
-                // Not called from the JUCE message thread! Please report this as a bug.
-                jassert(MessageManager::getInstance()->isThisTheMessageThread());
+        public:
+            MessageThreadWorker(JUCEDispatcher& dispatcher, int laneIndex, bool deliversInline)
+            : dispatcher(dispatcher),
+              queue(std::make_shared<WorkerQueue>(laneIndex)),
+              deliversInline(deliversInline)
+            {}
+
+            clock_type::time_point now() const override { return clock_type::now(); }
 
-                *static_cast<RunLoop_ptr*>(rl) = new rxcpp::schedulers::run_loop();
-                return static_cast<void*>(nullptr);
-            };
+            void schedule(const rxsc::schedulable& scbl) const override
+            {
+                if (deliversInline && MessageManager::existsAndIsCurrentThread() && dispatcher.runInline(queue, scbl))
+                    return;
+
+                dispatcher.schedule(queue, now(), scbl);
+            }
+
+            void schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const override
+            {
+                dispatcher.schedule(queue, when, scbl);
+            }
+
+        private:
+            JUCEDispatcher& dispatcher;
+            const std::shared_ptr<WorkerQueue> queue;
+            const bool deliversInline;
+        };
+
+        class MessageThreadScheduler : public rxsc::scheduler_interface
+        {
+        public:
+            MessageThreadScheduler(JUCEDispatcher& dispatcher, int laneIndex, bool deliversInline)
+            : dispatcher(dispatcher),
+              laneIndex(laneIndex),
+              deliversInline(deliversInline)
+            {}
 
-            // This will block if this thread isn't the message thread:
-            MessageManager::getInstance()->callFunctionOnMessageThread(create, &rl);
+            clock_type::time_point now() const override { return clock_type::now(); }
 
-            return rl;
+            rxsc::worker create_worker(rxcpp::composite_subscription cs) const override
+            {
+                return rxsc::worker(cs, std::make_shared<MessageThreadWorker>(dispatcher, laneIndex, deliversInline));
+            }
+
+        private:
+            JUCEDispatcher& dispatcher;
+            const int laneIndex;
+            const bool deliversInline;
+        };
+
+        CriticalSection criticalSection;
+        Lane lanes[numLanes];
+        uint64 nextSequenceNumber = 0;
+        std::atomic<Clock::duration::rep> timeBudget;
+        Clock::time_point nextDispatchTime;
+        rxsc::recursion recursion;
+        const rxsc::scheduler schedulers[numLanes];
+        const rxsc::scheduler inlineSchedulers[numLanes];
+
+        // Runs the item right away, if the worker has no other items that must go first. Must be called on the message thread.
+        bool runInline(const std::shared_ptr<WorkerQueue>& queue, const rxsc::schedulable& what)
+        {
+            if (!what.is_subscribed())
+                return true;
+
+            {
+                const ScopedLock lock(criticalSection);
+
+                // Keep the order: Queued items, and the item that's running (which may be scheduling this one), go first
+                if (!queue->items.empty() || queue->isRunning)
+                    return false;
+
+                queue->isRunning = true;
+                stats->onEnqueued();
+                stats->onProcessed(Clock::duration::zero());
+            }
+
+            what(recursion.get_recurse());
+
+            const ScopedLock lock(criticalSection);
+            queue->isRunning = false;
+            return true;
+        }
+
+        void schedule(const std::shared_ptr<WorkerQueue>& queue, Clock::time_point when, const rxsc::schedulable& what)
+        {
+            if (!what.is_subscribed())
+                return;
+
+            {
+                const ScopedLock lock(criticalSection);
+
+                if (!queue->isActive) {
+                    queue->isActive = true;
+                    lanes[queue->laneIndex].queues.push_back(queue);
+                }
+
+                queue->items.push(detail::ScheduledItem{ when, nextSequenceNumber++, what });
+                stats->onEnqueued();
+
+                // If a message or Timer is already pending for an earlier time, there's nothing else to do
+                if (when >= nextDispatchTime)
+                    return;
+
+                nextDispatchTime = when;
+            }
+
+            triggerAsyncUpdate();
+        }
+
+        void handleAsyncUpdate() override
+        {
+            dispatchDueItems();
         }
 
         void timerCallback() override
         {
-            // Run any scheduled actions
-            while (!runLoop->empty() && runLoop->peek().when < runLoop->now())
-                runLoop->dispatch();
+            stopTimer();
+            dispatchDueItems();
+        }
+
+        void dispatchDueItems()
+        {
+            const auto deadline = Clock::now() + Clock::duration(timeBudget.load());
+            const ScopedLock lock(criticalSection);
+            int numItems = 0;
+
+            while (const auto queue = findDueQueue(Clock::now())) {
+                const auto item = queue->items.top();
+                queue->items.pop();
+                stats->onProcessed(Clock::now() - item.when);
+                ++numItems;
+
+                queue->isRunning = true;
+                {
+                    const ScopedUnlock unlock(criticalSection);
+                    item.what(recursion.get_recurse());
+                }
+                queue->isRunning = false;
+
+                if (Clock::now() >= deadline) {
+                    // Out of time. Continue with the next queue in the next message.
+                    stats->onTick(numItems);
+                    nextDispatchTime = Clock::time_point::min();
+                    stopTimer();
+                    triggerAsyncUpdate();
+                    return;
+                }
+            }
+
+            if (numItems > 0)
+                stats->onTick(numItems);
+
+            scheduleNextDispatch();
+        }
+
+        // Returns the next queue that has a due item: From the highest priority lane that has one, and within that lane, the queue after the one that was dispatched last. Must be called with the lock held.
+        std::shared_ptr<WorkerQueue> findDueQueue(Clock::time_point now)
+        {
+            for (auto& lane : lanes) {
+                for (size_t numVisited = lane.queues.size(); numVisited > 0 && !lane.queues.empty(); --numVisited) {
+                    if (lane.nextQueueIndex >= lane.queues.size())
+                        lane.nextQueueIndex = 0;
+
+                    const auto queue = lane.queues[lane.nextQueueIndex];
+                    removeUnsubscribedItems(*queue);
+
+                    if (queue->items.empty()) {
+                        queue->isActive = false;
+                        lane.queues.erase(lane.queues.begin() + static_cast<std::ptrdiff_t>(lane.nextQueueIndex));
+                        continue;
+                    }
+
+                    ++lane.nextQueueIndex;
+
+                    if (queue->items.top().when <= now)
+                        return queue;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void removeUnsubscribedItems(WorkerQueue& queue)
+        {
+            while (!queue.items.empty() && !queue.items.top().what.is_subscribed()) {
+                queue.items.pop();
+                stats->onRemoved();
+            }
+        }
+
+        // Must be called with the lock held
+        void scheduleNextDispatch()
+        {
+            nextDispatchTime = Clock::time_point::max();
+
+            for (auto& lane : lanes) {
+                for (auto& queue : lane.queues) {
+                    if (!queue->items.empty())
+                        nextDispatchTime = jmin(nextDispatchTime, queue->items.top().when);
+                }
+            }
+
+            if (nextDispatchTime == Clock::time_point::max()) {
+                stopTimer();
+                return;
+            }
+
+            const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(nextDispatchTime - Clock::now()).count();
+
+            if (delay <= 0) {
+                stopTimer();
+                triggerAsyncUpdate();
+            }
+            else
+                // Round up, so the item is due when the Timer fires
+                startTimer(static_cast<int>(jmin<int64>(delay + 1, std::numeric_limits<int>::max())));
         }
     };
+
+    JUCEDispatcher& getMessageThreadDispatcher()
+    {
+        static JUCEDispatcher dispatcher;
+        return dispatcher;
+    }
+
+#pragma mark - Thread Pool
+
+    class Strand;
+
+    // Runs Strands on a set of threads
+    class StrandExecutor
+    {
+    public:
+        virtual ~StrandExecutor() {}
+
+        // The stats of all Strands that run on this executor
+        const std::shared_ptr<detail::SchedulerStatsImpl> stats = std::make_shared<detail::SchedulerStatsImpl>();
+
+        // Queues a Strand to be run. If `yield` is true, the Strand has just run and other work should go first.
+        virtual void submit(const std::shared_ptr<Strand>& strand, bool yield = false) = 0;
+
+        // Wakes up the Strand when `when` has been reached
+        virtual void submitDelayed(Clock::time_point when, const std::weak_ptr<Strand>& strand) = 0;
+    };
+
+    /**
+     The rx worker of a thread pool Scheduler. There's one per subscription.
+     
+     It runs its items in order, one at a time, so values are delivered in sequence like on a single thread. But it's not bound to a specific thread: Whenever it has due items, it's submitted to the StrandExecutor and run by whichever thread gets to it first.
+     */
+    class Strand : public rxsc::worker_interface
+    {
+    public:
+        explicit Strand(const std::shared_ptr<StrandExecutor>& executor)
+        : executor(executor)
+        {}
+
+        ~Strand()
+        {
+            // Items that were never run
+            executor->stats->onRemoved(items.size());
+        }
+
+        clock_type::time_point now() const override { return clock_type::now(); }
+
+        void schedule(const rxsc::schedulable& scbl) const override
+        {
+            schedule(now(), scbl);
+        }
+
+        void schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const override;
+
+        // Runs due items. Called by the StrandExecutor.
+        void run();
+
+        // Queues the Strand on the pool if it has due items and isn't queued yet. Called when a delayed item is due.
+        void wakeUp();
+
+    private:
+        // The maximum number of items to run at once, before giving other Strands a turn
+        static const int maxItemsPerRun = 64;
+
+        const std::shared_ptr<StrandExecutor> executor;
+        const CriticalSection criticalSection;
+        mutable detail::ScheduledItemQueue items;
+        mutable uint64 nextSequenceNumber = 0;
+        mutable bool isQueued = false;
+        rxsc::recursion recursion;
+
+        std::shared_ptr<Strand> getSharedThis() const
+        {
+            return std::static_pointer_cast<Strand>(std::const_pointer_cast<rxsc::worker_interface>(shared_from_this()));
+        }
+
+        // Must be called with the lock held
+        bool hasDueItem() const
+        {
+            while (!items.empty() && !items.top().what.is_subscribed()) {
+                items.pop();
+                executor->stats->onRemoved();
+            }
+
+            return (!items.empty() && items.top().when <= Clock::now());
+        }
+    };
+
+    // A pool thread. It has its own deque of Strands: It runs the Strands it has queued itself in LIFO order, and other threads steal from the opposite end.
+    class WorkStealingPool;
+
+    class PoolThread : public Thread
+    {
+    public:
+        PoolThread(WorkStealingPool& pool, int index)
+        : Thread("ReaX Pool Thread " + String(index)),
+          pool(pool)
+        {}
+
+        void run() override;
+
+        void pushBack(const std::shared_ptr<Strand>& strand)
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+            strands.push_back(strand);
+        }
+
+        void pushFront(const std::shared_ptr<Strand>& strand)
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+            strands.push_front(strand);
+        }
+
+        std::shared_ptr<Strand> popBack()
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+
+            if (strands.empty())
+                return nullptr;
+
+            const auto strand = strands.back();
+            strands.pop_back();
+            return strand;
+        }
+
+        std::shared_ptr<Strand> popFront()
+        {
+            const SpinLock::ScopedLockType lock(spinLock);
+
+            if (strands.empty())
+                return nullptr;
+
+            const auto strand = strands.front();
+            strands.pop_front();
+            return strand;
+        }
+
+        // Wakes the thread up if it's idle. Returns false if it's busy.
+        bool wakeUpIfIdle()
+        {
+            if (!isIdle.exchange(false))
+                return false;
+
+            wakeUpEvent.signal();
+            return true;
+        }
+
+        void wakeUp()
+        {
+            wakeUpEvent.signal();
+        }
+
+        WorkStealingPool& pool;
+
+    private:
+        SpinLock spinLock;
+        std::deque<std::shared_ptr<Strand>> strands;
+        std::atomic<bool> isIdle{ false };
+        WaitableEvent wakeUpEvent;
+    };
+
+    // Wakes up Strands when their delayed items are due.
+    class DelayThread : public Thread
+    {
+    public:
+        DelayThread()
+        : Thread("ReaX Delay Thread")
+        {
+            startThread();
+        }
+
+        ~DelayThread()
+        {
+            signalThreadShouldExit();
+            wakeUpEvent.signal();
+            stopThread(-1);
+        }
+
+        void add(Clock::time_point when, const std::weak_ptr<Strand>& strand)
+        {
+            bool isEarliest;
+            {
+                const ScopedLock lock(criticalSection);
+                isEarliest = (entries.empty() || when < entries.top().when);
+                entries.push(Entry{ when, strand });
+            }
+
+            if (isEarliest)
+                wakeUpEvent.signal();
+        }
+
+        void run() override
+        {
+            std::vector<std::weak_ptr<Strand>> dueStrands;
+
+            while (!threadShouldExit()) {
+                int timeout = -1;
+                {
+                    const ScopedLock lock(criticalSection);
+                    const auto now = Clock::now();
+
+                    while (!entries.empty() && entries.top().when <= now) {
+                        dueStrands.push_back(entries.top().strand);
+                        entries.pop();
+                    }
+
+                    if (!entries.empty()) {
+                        const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(entries.top().when - now).count();
+                        timeout = static_cast<int>(jmin<int64>(delay + 1, std::numeric_limits<int>::max()));
+                    }
+                }
+
+                for (auto& weakStrand : dueStrands) {
+                    if (auto strand = weakStrand.lock())
+                        strand->wakeUp();
+                }
+                dueStrands.clear();
+
+                wakeUpEvent.wait(timeout);
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            Clock::time_point when;
+            std::weak_ptr<Strand> strand;
+
+            bool operator<(const Entry& other) const { return (when > other.when); }
+        };
+
+        CriticalSection criticalSection;
+        std::priority_queue<Entry> entries;
+        WaitableEvent wakeUpEvent;
+    };
+
+    /**
+     A pool of threads with per-thread deques and work stealing.
+     
+     A Strand that's queued from a pool thread goes to that thread's own deque, so a pipeline tends to stay on the same thread. An idle thread steals from the other threads' deques. Strands that are queued from outside the pool are distributed round-robin.
+     
+     The threads are started once and shared by all Observables that use a pool of the same size.
+     */
+    class WorkStealingPool : public StrandExecutor
+    {
+    public:
+        explicit WorkStealingPool(int numThreads)
+        {
+            for (int i = 0; i < numThreads; ++i)
+                threads.add(new PoolThread(*this, i));
+
+            for (auto thread : threads)
+                thread->startThread();
+        }
+
+        ~WorkStealingPool()
+        {
+            for (auto thread : threads) {
+                thread->signalThreadShouldExit();
+                thread->wakeUp();
+            }
+
+            for (auto thread : threads)
+                thread->stopThread(-1);
+        }
+
+        static std::shared_ptr<WorkStealingPool> getShared(int numThreads)
+        {
+            static CriticalSection criticalSection;
+            static std::map<int, std::shared_ptr<WorkStealingPool>> pools;
+
+            const ScopedLock lock(criticalSection);
+            auto& pool = pools[numThreads];
+
+            if (!pool)
+                pool = std::make_shared<WorkStealingPool>(numThreads);
+
+            return pool;
+        }
+
+        // If `yield` is true, the Strand is queued behind the other Strands of the current thread
+        void submit(const std::shared_ptr<Strand>& strand, bool yield) override
+        {
+            if (currentThread && &currentThread->pool == this) {
+                if (yield)
+                    currentThread->pushFront(strand);
+                else
+                    currentThread->pushBack(strand);
+
+                // Let an idle thread steal it
+                for (auto thread : threads) {
+                    if (thread->wakeUpIfIdle())
+                        break;
+                }
+            }
+            else {
+                auto thread = threads[static_cast<int>(nextThreadIndex++ % static_cast<uint32>(threads.size()))];
+                thread->pushBack(strand);
+                thread->wakeUp();
+            }
+        }
+
+        void submitDelayed(Clock::time_point when, const std::weak_ptr<Strand>& strand) override
+        {
+            delayThread.add(when, strand);
+        }
+
+        // Returns the next Strand for a pool thread, stealing from other threads if it has none queued itself.
+        std::shared_ptr<Strand> findStrand(PoolThread& thread)
+        {
+            if (auto strand = thread.popBack())
+                return strand;
+
+            const int index = threads.indexOf(&thread);
+            for (int i = 1; i < threads.size(); ++i) {
+                if (auto strand = threads[(index + i) % threads.size()]->popFront())
+                    return strand;
+            }
+
+            return nullptr;
+        }
+
+        static thread_local PoolThread* currentThread;
+
+    private:
+        OwnedArray<PoolThread> threads;
+        DelayThread delayThread;
+        std::atomic<uint32> nextThreadIndex{ 0 };
+    };
+
+    thread_local PoolThread* WorkStealingPool::currentThread = nullptr;
+
+    void PoolThread::run()
+    {
+        WorkStealingPool::currentThread = this;
+
+        while (!threadShouldExit()) {
+            if (auto strand = pool.findStrand(*this)) {
+                strand->run();
+                continue;
+            }
+
+            // Mark this thread as idle before checking again, so a Strand that's queued in between wakes it up
+            isIdle.store(true);
+
+            if (auto strand = pool.findStrand(*this)) {
+                isIdle.store(false);
+                strand->run();
+                continue;
+            }
+
+            wakeUpEvent.wait(-1);
+            isIdle.store(false);
+        }
+    }
+
+    void Strand::schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const
+    {
+        if (!scbl.is_subscribed())
+            return;
+
+        const bool isDue = (when <= Clock::now());
+        bool shouldSubmit = false;
+        {
+            const ScopedLock lock(criticalSection);
+            items.push(detail::ScheduledItem{ when, nextSequenceNumber++, scbl });
+            executor->stats->onEnqueued();
+
+            if (isDue && !isQueued) {
+                isQueued = true;
+                shouldSubmit = true;
+            }
+        }
+
+        if (shouldSubmit)
+            executor->submit(getSharedThis());
+        else if (!isDue)
+            executor->submitDelayed(when, getSharedThis());
+    }
+
+    void Strand::run()
+    {
+        const ScopedLock lock(criticalSection);
+
+        for (int numItems = 0; numItems < maxItemsPerRun; ++numItems) {
+            if (!hasDueItem()) {
+                if (numItems > 0)
+                    executor->stats->onTick(numItems);
+
+                // Items that aren't due yet are woken up by the DelayThread
+                isQueued = false;
+                return;
+            }
+
+            const auto item = items.top();
+            items.pop();
+            executor->stats->onProcessed(Clock::now() - item.when);
+            recursion.reset(items.empty());
+
+            const ScopedUnlock unlock(criticalSection);
+            item.what(recursion.get_recurse());
+        }
+
+        executor->stats->onTick(maxItemsPerRun);
+
+        // Still queued, give other Strands a turn
+        executor->submit(getSharedThis(), true);
+    }
+
+    void Strand::wakeUp()
+    {
+        {
+            const ScopedLock lock(criticalSection);
+
+            if (isQueued || !hasDueItem())
+                return;
+
+            isQueued = true;
+        }
+
+        executor->submit(getSharedThis());
+    }
+
+    // Runs Strands as jobs on a juce::ThreadPool that's owned by someone else
+    class JUCEThreadPoolExecutor : public StrandExecutor
+    {
+    public:
+        explicit JUCEThreadPoolExecutor(ThreadPool& threadPool)
+        : threadPool(threadPool)
+        {}
+
+        void submit(const std::shared_ptr<Strand>& strand, bool) override
+        {
+            // The ThreadPool runs jobs in the order they were added, so a yielding Strand is queued behind the other jobs anyway
+            threadPool.addJob(new StrandJob(strand), true);
+        }
+
+        void submitDelayed(Clock::time_point when, const std::weak_ptr<Strand>& strand) override
+        {
+            static DelayThread delayThread;
+            delayThread.add(when, strand);
+        }
+
+    private:
+        class StrandJob : public ThreadPoolJob
+        {
+        public:
+            explicit StrandJob(const std::shared_ptr<Strand>& strand)
+            : ThreadPoolJob("ReaX Strand"),
+              strand(strand)
+            {}
+
+            JobStatus runJob() override
+            {
+                strand->run();
+                return jobHasFinished;
+            }
+
+        private:
+            const std::shared_ptr<Strand> strand;
+        };
+
+        ThreadPool& threadPool;
+    };
+
+    class ThreadPoolScheduler : public rxsc::scheduler_interface
+    {
+    public:
+        explicit ThreadPoolScheduler(const std::shared_ptr<StrandExecutor>& executor)
+        : executor(executor)
+        {}
+
+        clock_type::time_point now() const override { return clock_type::now(); }
+
+        rxsc::worker create_worker(rxcpp::composite_subscription cs) const override
+        {
+            return rxsc::worker(cs, std::make_shared<Strand>(executor));
+        }
+
+    private:
+        const std::shared_ptr<StrandExecutor> executor;
+    };
+
+#pragma mark - Instrumentation
+
+    /**
+     Collects stats for the workers of an rx scheduler that ReaX doesn't implement itself, like rxcpp's event loop.
+     
+     Each item is wrapped, so it can be counted when it's run. Items that are still queued when the worker is unsubscribed are never run, so they're removed from the stats then.
+     
+     Wrapping costs an allocation per item, and recursive items are rescheduled instead of looping. So this is only used if ThreadOptions::collectStats is set.
+     */
+    class InstrumentedWorker : public rxsc::worker_interface
+    {
+    public:
+        InstrumentedWorker(const rxsc::worker& worker, const std::shared_ptr<detail::SchedulerStatsImpl>& stats)
+        : worker(worker),
+          stats(stats),
+          numPendingItems(std::make_shared<std::atomic<int>>(0))
+        {
+            const auto numPendingItems = this->numPendingItems;
+            worker.get_subscription().add([numPendingItems, stats]() {
+                stats->onRemoved(static_cast<size_t>(numPendingItems->exchange(0)));
+            });
+        }
+
+        clock_type::time_point now() const override { return worker.now(); }
+
+        void schedule(const rxsc::schedulable& scbl) const override
+        {
+            schedule(now(), scbl);
+        }
+
+        void schedule(clock_type::time_point when, const rxsc::schedulable& scbl) const override
+        {
+            stats->onEnqueued();
+            ++(*numPendingItems);
+
+            const auto stats = this->stats;
+            const auto numPendingItems = this->numPendingItems;
+            worker.schedule(when, rxsc::make_schedulable(worker, [scbl, when, stats, numPendingItems](const rxsc::schedulable&) {
+                // If the worker has been unsubscribed in the meantime, the item has been removed already
+                int numPending = numPendingItems->load();
+                do {
+                    if (numPending <= 0)
+                        return;
+                } while (!numPendingItems->compare_exchange_weak(numPending, numPending - 1));
+
+                stats->onProcessed(Clock::now() - when);
+
+                // Recursive actions are rescheduled, so each one is counted
+                rxsc::recursion recursion;
+                recursion.reset(false);
+                scbl(recursion.get_recurse());
+            }));
+        }
+
+    private:
+        const rxsc::worker worker;
+        const std::shared_ptr<detail::SchedulerStatsImpl> stats;
+        const std::shared_ptr<std::atomic<int>> numPendingItems;
+    };
+
+    class InstrumentedScheduler : public rxsc::scheduler_interface
+    {
+    public:
+        InstrumentedScheduler(const rxsc::scheduler& scheduler, const std::shared_ptr<detail::SchedulerStatsImpl>& stats)
+        : scheduler(scheduler),
+          stats(stats)
+        {}
+
+        clock_type::time_point now() const override { return scheduler.now(); }
+
+        rxsc::worker create_worker(rxcpp::composite_subscription cs) const override
+        {
+            return rxsc::worker(cs, std::make_shared<InstrumentedWorker>(scheduler.create_worker(cs), stats));
+        }
+
+    private:
+        const rxsc::scheduler scheduler;
+        const std::shared_ptr<detail::SchedulerStatsImpl> stats;
+    };
+
+    // Serializes emissions from several threads onto the workers of the given rx scheduler. If `stats` isn't null, it collects stats for it.
+    std::shared_ptr<detail::SchedulerImpl> createSerializedSchedulerImpl(const rxsc::scheduler& scheduler, const std::shared_ptr<detail::SchedulerStatsImpl>& stats)
+    {
+        const auto actualScheduler = (stats ? rxsc::make_scheduler<InstrumentedScheduler>(scheduler, stats) : scheduler);
+        const auto coordination = rxcpp::serialize_one_worker(actualScheduler);
+        return std::make_shared<detail::SchedulerImpl>([coordination](const rxcpp::observable<detail::any>& observable) {
+            return observable.observe_on(coordination);
+        },
+                                                       std::make_shared<rxsc::scheduler>(actualScheduler),
+                                                       stats);
+    }
+
+#pragma mark - Helpers
+
+    // Sets the priority (0 to 10) of the calling thread
+    void setCurrentThreadPriority(int priority)
+    {
+#if JUCE_LINUX
+        // juce::Thread would switch to a realtime policy, which needs privileges. Normal threads are prioritized by their nice value instead.
+        const int niceValue = jlimit(-20, 19, (5 - priority) * 4);
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), niceValue);
+#else
+        Thread::setCurrentThreadPriority(priority);
+#endif
+    }
+
+    // Creates rxcpp threads that apply the given options when they start
+    rxsc::thread_factory createThreadFactory(const ThreadOptions& options)
+    {
+        return [options](std::function<void()> run) {
+            return std::thread([options, run]() {
+                if (options.name.isNotEmpty())
+                    Thread::setCurrentThreadName(options.name);
+
+                if (options.priority >= 0)
+                    setCurrentThreadPriority(options.priority);
+
+                if (options.affinityMask != 0)
+                    Thread::setCurrentThreadAffinityMask(options.affinityMask);
+
+                run();
+            });
+        };
+    }
+
+    // Observes on the workers of the given rx scheduler, and uses it for time-based operators as well
+    std::shared_ptr<detail::SchedulerImpl> createSchedulerImpl(const rxsc::scheduler& scheduler, const std::shared_ptr<detail::SchedulerStatsImpl>& stats = nullptr)
+    {
+        const rxcpp::observe_on_one_worker coordination(scheduler);
+        return std::make_shared<detail::SchedulerImpl>([coordination](const rxcpp::observable<detail::any>& observable) {
+            return observable.observe_on(coordination);
+        },
+                                                       std::make_shared<rxsc::scheduler>(scheduler),
+                                                       stats);
+    }
 }
 
 Scheduler::Scheduler(const std::shared_ptr<detail::SchedulerImpl>& impl)
 : impl(impl) {}
 
-Scheduler Scheduler::messageThread()
+Scheduler Scheduler::messageThread(Priority priority, Delivery delivery)
 {
-    static const JUCEDispatcher dispatcher;
-    const auto worker = dispatcher.createWorker();
-    return std::make_shared<detail::SchedulerImpl>([worker](const rxcpp::observable<detail::any>& observable) {
-        return observable.observe_on(worker);
-    });
+    auto& dispatcher = getMessageThreadDispatcher();
+    return createSchedulerImpl(dispatcher.getScheduler(priority, delivery), dispatcher.getStats());
 }
 
-Scheduler Scheduler::backgroundThread()
+void Scheduler::setMessageThreadTimeBudget(const RelativeTime& budget)
 {
-    return std::make_shared<detail::SchedulerImpl>([](const rxcpp::observable<detail::any>& observable) {
-        return observable.observe_on(rxcpp::serialize_event_loop());
-    });
+    getMessageThreadDispatcher().setTimeBudget(budget);
+}
+
+Scheduler Scheduler::backgroundThread(const ThreadOptions& options)
+{
+    // The priority must be between 0 and 10, or -1!
+    jassert(options.priority == -1 || isPositiveAndNotGreaterThan(options.priority, 10));
+
+    // One event loop (with its own stats) per set of options
+    static CriticalSection criticalSection;
+    static std::map<String, std::shared_ptr<detail::SchedulerImpl>> eventLoops;
+
+    const ScopedLock lock(criticalSection);
+    auto& eventLoop = eventLoops[options.name + "|" + String(options.priority) + "|" + String(options.affinityMask) + "|" + String(static_cast<int>(options.collectStats))];
+
+    if (!eventLoop)
+        eventLoop = createSerializedSchedulerImpl(rxsc::make_event_loop(createThreadFactory(options)), (options.collectStats ? std::make_shared<detail::SchedulerStatsImpl>() : nullptr));
+
+    return eventLoop;
 }
 
-Scheduler Scheduler::newThread()
+Scheduler Scheduler::newThread(const ThreadOptions& options)
 {
-    return std::make_shared<detail::SchedulerImpl>([](const rxcpp::observable<detail::any>& observable) {
-        return observable.observe_on(rxcpp::serialize_new_thread());
+    // The priority must be between 0 and 10, or -1!
+    jassert(options.priority == -1 || isPositiveAndNotGreaterThan(options.priority, 10));
+
+    // The stats of all new threads together
+    static const auto stats = std::make_shared<detail::SchedulerStatsImpl>();
+    return createSerializedSchedulerImpl(rxsc::make_new_thread(createThreadFactory(options)), (options.collectStats ? stats : nullptr));
+}
+
+Scheduler Scheduler::threadPool(int numThreads)
+{
+    // The number of threads must be at least 1!
+    jassert(numThreads > 0);
+
+    const auto pool = WorkStealingPool::getShared(jmax(1, numThreads));
+    return createSchedulerImpl(rxsc::make_scheduler<ThreadPoolScheduler>(pool), pool->stats);
+}
+
+Scheduler Scheduler::fromThreadPool(ThreadPool& threadPool)
+{
+    const auto executor = std::make_shared<JUCEThreadPoolExecutor>(threadPool);
+    return createSchedulerImpl(rxsc::make_scheduler<ThreadPoolScheduler>(executor), executor->stats);
+}
+
+Scheduler Scheduler::trampoline()
+{
+    return createSchedulerImpl(rxsc::make_current_thread());
+}
+
+Scheduler Scheduler::realtime(RealtimeDrainPoint& drainPoint)
+{
+    const auto impl = drainPoint.impl;
+    return std::make_shared<detail::SchedulerImpl>([impl](const rxcpp::observable<detail::any>& observable) {
+        return impl->schedule(observable);
     });
 }
+
+Scheduler Scheduler::virtualTime(VirtualClock& clock)
+{
+    return createSchedulerImpl(clock.impl->createScheduler());
+}
+
+SchedulerStats Scheduler::getStats() const
+{
+    if (!impl->stats)
+        return SchedulerStats();
+
+    return impl->stats->getStats();
+}
+
+RealtimeDrainPoint::RealtimeDrainPoint(size_t capacity)
+: impl(std::make_shared<detail::RealtimeDrainPointImpl>(capacity))
+{}
+
+void RealtimeDrainPoint::drain()
+{
+    impl->drain();
+}
+
+uint64 RealtimeDrainPoint::getNumDroppedValues() const
+{
+    return impl->getNumDroppedValues();
+}
+
+VirtualClock::VirtualClock()
+: impl(std::make_shared<detail::VirtualClockImpl>())
+{}
+
+void VirtualClock::advanceBy(const RelativeTime& time)
+{
+    // Can't go back in time!
+    jassert(time.inSeconds() >= 0);
+
+    impl->advanceBy(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(jmax(0.0, time.inSeconds()))));
+}
+
+RelativeTime VirtualClock::getElapsedTime() const
+{
+    return RelativeTime(std::chrono::duration<double>(impl->getElapsedTime()).count());
+}
@@ -2,26 +2,198 @@
 
 namespace detail {
     struct SchedulerImpl;
+    class RealtimeDrainPointImpl;
+    class VirtualClockImpl;
 }
 
+template<typename T>
+class Observable;
+
+class RealtimeDrainPoint;
+class VirtualClock;
+
+/**
+ Options for the threads that Scheduler::backgroundThread and Scheduler::newThread start.
+ 
+ For example, to keep background work at a low priority and away from the cores that the audio threads usually run on:
+ 
+     ThreadOptions options;
+     options.name = "Analysis";
+     options.priority = 2;
+     options.affinityMask = 0b1100; // Cores 2 and 3
+     
+     spectrum.observeOn(Scheduler::backgroundThread(options))...
+ 
+ The options are applied with juce::Thread::setCurrentThreadName, juce::Thread::setCurrentThreadPriority and juce::Thread::setCurrentThreadAffinityMask, when a thread starts. On Linux, juce::Thread can't change the priority of normal threads, so the priority sets the thread's nice value instead: Lower priorities are nicer, 5 is the normal nice value 0. Priorities above 5 need the CAP_SYS_NICE capability, and are ignored without it.
+ */
+struct ThreadOptions
+{
+    /// The name of the threads, e.g. to find them in a debugger or profiler. If empty, the name isn't changed.
+    juce::String name;
+
+    /// The priority from 0 (lowest) to 10 (highest), like juce::Thread priorities. If it's -1 (the default), the priority isn't changed.
+    int priority = -1;
+
+    /// The cores that the threads may run on: Bit n stands for core n. If it's 0 (the default), the threads may run on any core.
+    juce::uint32 affinityMask = 0;
+
+    /// Whether the Scheduler collects stats (see Scheduler::getStats). This wraps every value that's observed on it, which costs an extra allocation per value, so it's off by default.
+    bool collectStats = false;
+};
+
+/**
+ How busy a Scheduler is, and how far behind it is. @see Scheduler::getStats
+ 
+ The Scheduler counts *items*: Usually, each value that's observed on the Scheduler is one item. The counts and latencies are collected since the Scheduler was first used.
+ */
+struct SchedulerStats
+{
+    /// The number of items that are currently waiting to be processed
+    int queueDepth = 0;
+
+    /// The largest queueDepth so far
+    int maxQueueDepth = 0;
+
+    /// The number of items that have been processed so far
+    juce::uint64 numProcessed = 0;
+
+    /// The time between an item being due and being processed. Percentiles are approximate: They are rounded up to the next power of two microseconds.
+    juce::RelativeTime medianLatency, latency95th, latency99th;
+
+    /// The longest time an item had to wait before being processed
+    juce::RelativeTime maxLatency;
+
+    /// The average number of items that are processed at once (e.g. in a single message on the message thread). Zero for Schedulers that don't process items in batches (Scheduler::backgroundThread and Scheduler::newThread).
+    double averageItemsPerTick = 0;
+
+    /// The largest number of items that were processed at once
+    int maxItemsPerTick = 0;
+};
+
 /**
     A Scheduler is used to process parts of an Observable on a specific thread.
  
-    Use the Scheduler::messageThread, Scheduler::backgroundThread and Scheduler::newThread member functions and pass the returned Scheduler to Observable::observeOn.
+    Use the Scheduler::messageThread, Scheduler::backgroundThread, Scheduler::newThread and Scheduler::threadPool member functions and pass the returned Scheduler to Observable::observeOn.
  
     @see Observable::observeOn
  */
 class Scheduler
 {
 public:
-    /// The JUCE message thread. 
-    static Scheduler messageThread();
+    /// The priority of values that are processed on the message thread. @see Scheduler::messageThread
+    enum class Priority {
+        /// For interactive feedback, e.g. a slider's own value. Always processed first.
+        High,
+
+        /// The default
+        Normal,
+
+        /// For bulk updates, e.g. meters. Processed when there are no values with higher priority, in the remaining time budget.
+        Background
+    };
+
+    /// How values are delivered on the message thread. @see Scheduler::messageThread
+    enum class Delivery {
+        /// Values are always queued, and processed in a later message. The default.
+        Queued,
+
+        /**
+         If a value is emitted on the message thread, and no other values of the same subscription are waiting, it's processed right away, without waiting for the next message. This saves up to a frame of latency, e.g. when a Slider's value is bound to a Label.
+         
+         Otherwise, it's queued as usual. So the values of a subscription are still processed in order.
+         */
+        InlineIfIdle
+    };
+
+    /**
+     The JUCE message thread.
+     
+     Values are processed by priority: While there are values from a Scheduler with a higher priority, values from Schedulers with a lower priority wait. Values with the same priority are processed in turn.
+     
+     With Delivery::InlineIfIdle, values that are emitted on the message thread skip the queue if possible.
+     */
+    static Scheduler messageThread(Priority priority = Priority::Normal, Delivery delivery = Delivery::Queued);
 
-    /// A shared background thread. Use this if you don't want to block the message thread, but don't want to spawn a new thread either. The thread is shared between Observables. 
-    static Scheduler backgroundThread();
+    /**
+     Sets how long the message thread may spend processing scheduled values at once. When the time is up, the remaining values are processed in the next message, so painting and mouse handling stay responsive. The default is 4 ms.
+     
+     Values from different subscriptions are processed in turn, so one busy Observable doesn't delay the others.
+     */
+    static void setMessageThreadTimeBudget(const juce::RelativeTime& budget);
 
-    /// Makes the Observable spawn a new thread. 
-    static Scheduler newThread();
+    /**
+     A shared background thread. Use this if you don't want to block the message thread, but don't want to spawn a new thread either. The thread is shared between Observables.
+     
+     Schedulers with the same ThreadOptions share the same threads.
+     */
+    static Scheduler backgroundThread(const ThreadOptions& options = ThreadOptions());
+
+    /// Makes the Observable spawn a new thread, with the given ThreadOptions.
+    static Scheduler newThread(const ThreadOptions& options = ThreadOptions());
+
+    /**
+     A shared pool of `numThreads` threads. Use this to spread independent Observables across several cores, without spawning a thread for each one.
+     
+     Each subscription is still processed in order, one value at a time, but not necessarily on the same thread. Pools with the same number of threads are shared, and their threads are only started once.
+     */
+    static Scheduler threadPool(int numThreads = juce::SystemStats::getNumCpus());
+
+    /**
+     Processes values as jobs on an existing juce::ThreadPool, so Observables share the threads (and their priorities) with the rest of the app, instead of starting threads of their own.
+     
+     Ordering guarantees:
+     
+     - The values of a single subscription are processed in the order they were emitted, and never concurrently. But consecutive values may be processed on different threads of the pool.
+     - There's no ordering between different subscriptions. They are processed concurrently, as far as the pool has free threads.
+     - A subscription with many pending values processes up to 64 of them per job, and then adds a new job, so other jobs in the pool get a turn.
+     
+     The ThreadPool must outlive all Observables that are scheduled on it.
+     */
+    static Scheduler fromThreadPool(juce::ThreadPool& threadPool);
+
+    /**
+     The current thread, with a trampoline: If an action is scheduled while another one is running on the same thread, it's queued, and run when the current one has returned. So re-entrant emissions run in a loop instead of recursing.
+     
+     Pass it to Observable::concat or Observable::flatMap to subscribe to many synchronous Observables without growing the stack.
+     */
+    static Scheduler trampoline();
+
+    /**
+     A realtime thread, like the audio thread. Values are put into the lock-free queue of the given RealtimeDrainPoint, and delivered when the realtime thread calls RealtimeDrainPoint::drain.
+     
+     This is useful to pass data that's computed in the background (e.g. new filter coefficients) to the audio thread:
+     
+         coefficients.observeOn(Scheduler::realtime(drainPoint)).subscribe([this](const Coefficients& c) {
+             filter.setCoefficients(c); // Called on the audio thread
+         });
+     
+     onError and onCompleted are delivered on the message thread instead, after all values have been delivered. That's because ending a subscription frees memory.
+     
+     **This Scheduler can only be used with Observable::observeOn.** It can't run the timers of time-based operators, or subscribe via Observable::subscribeOn.
+     */
+    static Scheduler realtime(RealtimeDrainPoint& drainPoint);
+
+    /**
+     A virtual time, that only passes when you call VirtualClock::advanceBy. Actions run on the thread that advances the clock.
+     
+     Use this to test time-based operators (e.g. Observable::debounce, Observable::sample or Observable::interval) deterministically, without waiting. An hour of virtual time passes in milliseconds:
+     
+         VirtualClock clock;
+         auto ticks = Observable<int>::interval(RelativeTime::seconds(1), Scheduler::virtualTime(clock));
+         ...
+         clock.advanceBy(RelativeTime::hours(1));
+     */
+    static Scheduler virtualTime(VirtualClock& clock);
+
+    /**
+     Returns the current stats of this Scheduler, e.g. how many values are waiting to be processed. This can be called from any thread.
+     
+     Schedulers that share threads share their stats, too: All Scheduler::messageThread priorities have the same stats, as do all Scheduler::newThread Schedulers and all Scheduler::threadPool Schedulers with the same number of threads. Scheduler::backgroundThread and Scheduler::newThread only collect stats if ThreadOptions::collectStats is set. Scheduler::realtime and Scheduler::virtualTime don't collect stats. If a Scheduler doesn't collect stats, all values are zero.
+     */
+    SchedulerStats getStats() const;
+
+    /// Returns an Observable that emits the stats of this Scheduler every `interval`, on the message thread. @see getStats
+    Observable<SchedulerStats> observeStats(const juce::RelativeTime& interval = juce::RelativeTime::seconds(1)) const;
 
 private:
     template<typename T>
@@ -32,3 +204,86 @@ private:
 
     JUCE_LEAK_DETECTOR(Scheduler)
 };
+
+/**
+ The point in a realtime thread (e.g. the audio callback) where values that are observed on Scheduler::realtime are delivered.
+ 
+ Call drain() regularly on the realtime thread, for example at the start of `processBlock`.
+ */
+class RealtimeDrainPoint
+{
+public:
+    /**
+     Creates a new instance. The queue has room for at least `capacity` values. Its memory is allocated up-front.
+     */
+    explicit RealtimeDrainPoint(size_t capacity = 1024);
+
+    /**
+     Delivers all queued values to their subscribers, in the order they were emitted.
+     
+     Does not allocate, free or lock. The operators after observeOn (and the subscriber's onNext) are called on this thread too, so they must not allocate or lock either.
+     */
+    void drain();
+
+    /// Returns how many values were dropped because the queue was full, i.e. because drain() wasn't called often enough.
+    juce::uint64 getNumDroppedValues() const;
+
+private:
+    friend class Scheduler;
+
+    const std::shared_ptr<detail::RealtimeDrainPointImpl> impl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeDrainPoint)
+};
+
+/**
+ A clock for Scheduler::virtualTime. Time only passes when advanceBy is called.
+ 
+ Copies share the same clock.
+ */
+class VirtualClock
+{
+public:
+    /// Creates a new clock. Its elapsed time is zero.
+    VirtualClock();
+
+    /// Advances the clock by the given time. Runs everything that's due until then, in order of the due times, on the calling thread.
+    void advanceBy(const juce::RelativeTime& time);
+
+    /// Returns how much virtual time has passed since the clock was created.
+    juce::RelativeTime getElapsedTime() const;
+
+private:
+    friend class Scheduler;
+
+    std::shared_ptr<detail::VirtualClockImpl> impl;
+
+    JUCE_LEAK_DETECTOR(VirtualClock)
+};
+
+/**
+ Counts values that were dropped, for example by Observable::observeOnLatest.
+ 
+ Copies share the same count, so you can keep a copy and read it while the Observable is running. Thread-safe.
+ */
+class DropCounter
+{
+public:
+    DropCounter()
+    : numDroppedValues(std::make_shared<std::atomic<juce::uint64>>(0))
+    {}
+
+    /// Returns the number of dropped values so far.
+    juce::uint64 getNumDroppedValues() const
+    {
+        return numDroppedValues->load();
+    }
+
+private:
+    template<typename T>
+    friend class Observable;
+
+    std::shared_ptr<std::atomic<juce::uint64>> numDroppedValues;
+
+    JUCE_LEAK_DETECTOR(DropCounter)
+};
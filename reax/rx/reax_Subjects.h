@@ -34,16 +34,27 @@ class BehaviorSubject : public Subject<T>
 public:
     /// Creates a new instance with a given initial value 
     explicit BehaviorSubject(const T& initial)
-    : Subject<T>(detail::SubjectImpl::MakeBehaviorSubjectImpl(detail::any(initial)))
+    : BehaviorSubject(initial, std::make_shared<detail::TypedValueSnapshot<T>>(initial))
     {}
 
-    /// Returns the most recently emitted value. If no values have been emitted, it returns the initial value. 
+    /**
+     Returns the most recently emitted value. If no values have been emitted, it returns the initial value.
+     
+     This doesn't lock or wait for the subject, so it can be called from any thread, including the audio thread. Trivially copyable values are read through a seqlock. Other values are read from an immutable snapshot, which is copied.
+     */
     T getValue() const
     {
-        return Subject<T>::impl.getValue().template get<T>();
+        return snapshot->load();
     }
 
 private:
+    std::shared_ptr<detail::TypedValueSnapshot<T>> snapshot;
+
+    BehaviorSubject(const T& initial, const std::shared_ptr<detail::TypedValueSnapshot<T>>& snapshot)
+    : Subject<T>(detail::SubjectImpl::MakeBehaviorSubjectImpl(detail::any(initial), snapshot)),
+      snapshot(snapshot)
+    {}
+
     JUCE_LEAK_DETECTOR(BehaviorSubject)
 };
 
@@ -78,12 +89,21 @@ public:
     /**
      Creates a new instance.
      
-     The `bufferSize` is the maximum number of values to remember and replay. Defaults to remembering "all" values (within memory boundaries). The buffer size is increased as values are emitted (not allocated upfront).
+     The `bufferSize` is the maximum number of values to remember and replay. Defaults to remembering "all" values (within memory boundaries), in which case the buffer grows as values are emitted. Otherwise, a ring of exactly `bufferSize` entries is allocated upfront, and once it's full, each new value replaces the oldest one.
      */
     explicit ReplaySubject(size_t bufferSize = std::numeric_limits<size_t>::max())
     : Subject<T>(detail::SubjectImpl::MakeReplaySubjectImpl(bufferSize))
     {}
 
+    /**
+     Creates a new instance that remembers and replays the values that were emitted within the given `window`, e.g. the last 5 seconds.
+     
+     Older values are dropped lazily, when a new value is emitted or when a subscriber is added. The `bufferSize` additionally limits the number of values to remember.
+     */
+    explicit ReplaySubject(const juce::RelativeTime& window, size_t bufferSize = std::numeric_limits<size_t>::max())
+    : Subject<T>(detail::SubjectImpl::MakeReplaySubjectImpl(window, bufferSize))
+    {}
+
 private:
     JUCE_LEAK_DETECTOR(ReplaySubject)
 };
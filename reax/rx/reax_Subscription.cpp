@@ -4,7 +4,12 @@ Subscription::Subscription(detail::any&& wrapped)
 
 void Subscription::unsubscribe() const
 {
-    wrapped.get<rxcpp::subscription>().unsubscribe();
+    wrapped.get<rxcpp::composite_subscription>().unsubscribe();
+}
+
+void Subscription::request(unsigned int numValues) const
+{
+    detail::DemandImpl::request(wrapped.get<rxcpp::composite_subscription>(), numValues);
 }
 
 void Subscription::disposedBy(DisposeBag& disposeBag)
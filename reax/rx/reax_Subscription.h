@@ -23,6 +23,17 @@ public:
     /// Unsubscribes from the Observable.
     void unsubscribe() const;
 
+    /**
+        Requests `numValues` more values from the Observable.
+     
+        This only has an effect if the Observable uses a backpressure operator, like Observable::onBackpressureBuffer. Such an Observable only emits as many values as have been requested. Otherwise, all values are emitted as soon as they are available, and calling this does nothing.
+     
+        May be called from any thread, and from within the `onNext` handler.
+     
+        @see Observable::onBackpressureBuffer, Observable::onBackpressureDrop and Observable::onBackpressureLatest
+     */
+    void request(unsigned int numValues) const;
+
     /**
         Moves the Subscription into a given DisposeBag. The Subscription is unsubscribed automatically when the DisposeBag is destroyed.
      
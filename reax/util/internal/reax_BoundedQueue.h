@@ -0,0 +1,101 @@
+#pragma once
+
+namespace detail {
+/**
+ A bounded multi-producer, multi-consumer FIFO queue. The storage for all values is allocated up-front, so enqueueing and dequeueing never allocate or lock.
+ 
+ Unlike moodycamel::ConcurrentQueue, values from different producer threads are dequeued in the order they were enqueued. So a sequence of values keeps its order, even if it hops between threads.
+ 
+ T must be default-constructible and move-assignable. Values are moved in and out of preallocated slots. A slot keeps the moved-from value until it's reused.
+ */
+template<typename T>
+class BoundedQueue
+{
+public:
+    /// The capacity is rounded up to the next power of two.
+    explicit BoundedQueue(size_t minimumCapacity)
+    : capacity(nextPowerOfTwo(juce::jmax<size_t>(minimumCapacity, 2))),
+      slots(new Slot[capacity])
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].sequenceNumber.store(i, std::memory_order_relaxed);
+    }
+
+    /// Moves `value` into the queue and returns true. Returns false if the queue is full, and leaves `value` untouched.
+    bool tryEnqueue(T&& value)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = slots[position & (capacity - 1)];
+            const size_t sequenceNumber = slot.sequenceNumber.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequenceNumber) - static_cast<std::ptrdiff_t>(position);
+
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequenceNumber.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Moves the oldest value out of the queue into `value` and returns true. Returns false if the queue is empty, and leaves `value` untouched.
+    bool tryDequeue(T& value)
+    {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+
+        for (;;) {
+            Slot& slot = slots[position & (capacity - 1)];
+            const size_t sequenceNumber = slot.sequenceNumber.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequenceNumber) - static_cast<std::ptrdiff_t>(position + 1);
+
+            if (difference == 0) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.sequenceNumber.store(position + capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+                return false;
+            else
+                position = dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// Returns true if the queue has no values. The result may be outdated immediately if other threads use the queue.
+    bool isEmpty() const
+    {
+        return (enqueuePosition.load(std::memory_order_acquire) == dequeuePosition.load(std::memory_order_acquire));
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequenceNumber;
+        T value;
+    };
+
+    const size_t capacity;
+    const std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePosition{ 0 };
+    std::atomic<size_t> dequeuePosition{ 0 };
+
+    static size_t nextPowerOfTwo(size_t n)
+    {
+        size_t result = 1;
+        while (result < n)
+            result <<= 1;
+
+        return result;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(BoundedQueue)
+};
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+namespace detail {
+/**
+ Holds a value that's read much more often than it's replaced, in the style of read-copy-update (RCU).
+
+ Readers get a const reference to an immutable snapshot without locking or allocating: They only increment and decrement one of two reader counters. A writer publishes a new snapshot with an atomic pointer swap and retires the old one. Retired snapshots are deleted on a later write (or in the destructor), once no reader can see them anymore.
+
+ Reading is wait-free, and can be done from any thread. Writes must be serialized by the caller, but they never wait for readers, so it's safe to write from within a read.
+ */
+template<typename T>
+class RcuCell
+{
+public:
+    explicit RcuCell(T initial = T())
+    : current(new Node(std::move(initial)))
+    {
+        readers[0] = 0;
+        readers[1] = 0;
+    }
+
+    ~RcuCell()
+    {
+        delete current.load();
+
+        for (auto node : retired)
+            delete node;
+    }
+
+    /// Calls the function with the current snapshot, and returns its result. The snapshot is valid until the function returns.
+    template<typename Function>
+    auto read(Function&& function) const -> decltype(function(std::declval<const T&>()))
+    {
+        const ReadGuard guard(*this);
+        return function(current.load()->value);
+    }
+
+    /// Returns a copy of the current snapshot.
+    T get() const
+    {
+        return read([](const T& value) { return value; });
+    }
+
+    /// Publishes a new snapshot. Must not be called concurrently with another write.
+    void set(T newValue)
+    {
+        Node* const previous = current.exchange(new Node(std::move(newValue)));
+        previous->retiredEpoch = epoch.load();
+        retired.push_back(previous);
+        reclaim();
+    }
+
+private:
+    struct Node
+    {
+        explicit Node(T&& value)
+        : value(std::move(value))
+        {}
+
+        const T value;
+        juce::uint64 retiredEpoch = 0;
+    };
+
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const RcuCell& cell)
+        : counter(cell.readers[cell.epoch.load() & 1])
+        {
+            ++counter;
+        }
+
+        ~ReadGuard()
+        {
+            --counter;
+        }
+
+    private:
+        std::atomic<juce::uint64>& counter;
+    };
+
+    std::atomic<Node*> current;
+    std::atomic<juce::uint64> epoch{ 0 };
+    mutable std::atomic<juce::uint64> readers[2];
+    std::vector<Node*> retired;
+
+    void reclaim()
+    {
+        // The epoch can advance from e to e + 1 when there are no readers with the other parity. A snapshot that's retired in epoch e has been unreachable since then, and any reader that still saw it has registered with one of the two parities. So when the epoch reaches e + 2, both parities have been empty at some point after the snapshot was retired, and it can be deleted.
+        for (int i = 0; i < 2; ++i) {
+            const auto e = epoch.load();
+
+            if (readers[(e + 1) & 1].load() != 0)
+                break;
+
+            epoch.store(e + 1);
+        }
+
+        const auto e = epoch.load();
+        retired.erase(std::remove_if(retired.begin(), retired.end(), [e](Node* node) {
+                          if (node->retiredEpoch + 2 > e)
+                              return false;
+
+                          delete node;
+                          return true;
+                      }),
+                      retired.end());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE(RcuCell)
+};
+}
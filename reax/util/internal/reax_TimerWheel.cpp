@@ -0,0 +1,217 @@
+namespace detail {
+TimerWheel::Timer::Timer(const std::function<void()>& callback)
+: callback(callback)
+{}
+
+TimerWheel& TimerWheel::getShared()
+{
+    static TimerWheel wheel;
+    return wheel;
+}
+
+TimerWheel::TimerWheel()
+: Thread("ReaX Timer Wheel"),
+  startTime(Clock::now())
+{
+    for (auto& level : slots) {
+        for (auto& slot : level)
+            slot = nullptr;
+    }
+
+    startThread();
+}
+
+TimerWheel::~TimerWheel()
+{
+    signalThreadShouldExit();
+    wakeUpEvent.signal();
+    stopThread(-1);
+
+    // Release the Timers that are still scheduled
+    const ScopedLock lock(criticalSection);
+
+    for (auto& level : slots) {
+        for (auto& slot : level) {
+            while (slot)
+                unlink(*slot);
+        }
+    }
+
+    while (overflow)
+        unlink(*overflow);
+}
+
+void TimerWheel::schedule(const std::shared_ptr<Timer>& timer, Clock::time_point when)
+{
+    // Round up in the Clock's own resolution, so the Timer never fires early
+    const Clock::duration delay = when - startTime;
+    const Clock::duration tick = std::chrono::milliseconds(1);
+    const auto dueTick = static_cast<uint64>(delay.count() > 0 ? (delay + tick - Clock::duration(1)) / tick : 0);
+
+    bool shouldWakeUp;
+    {
+        const ScopedLock lock(criticalSection);
+
+        if (timer->list)
+            unlink(*timer);
+
+        timer->keepAlive = timer;
+        timer->dueTick = dueTick;
+        insert(*timer, currentTick + 1);
+
+        // The thread is asleep until wakeUpTick
+        shouldWakeUp = (jmax(dueTick, currentTick + 1) < wakeUpTick);
+    }
+
+    if (shouldWakeUp)
+        wakeUpEvent.signal();
+}
+
+void TimerWheel::cancel(const std::shared_ptr<Timer>& timer)
+{
+    const ScopedLock lock(criticalSection);
+
+    if (timer->list)
+        unlink(*timer);
+}
+
+void TimerWheel::run()
+{
+    std::vector<std::shared_ptr<Timer>> dueTimers;
+
+    while (!threadShouldExit()) {
+        {
+            const ScopedLock lock(criticalSection);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime).count();
+            advanceTo(static_cast<uint64>(elapsed), dueTimers);
+
+            // Awake: Timers that are scheduled in the callbacks are found below
+            wakeUpTick = currentTick;
+        }
+
+        for (auto& timer : dueTimers)
+            timer->callback();
+
+        dueTimers.clear();
+
+        int timeout = -1;
+        {
+            const ScopedLock lock(criticalSection);
+            wakeUpTick = findWakeUpTick();
+
+            if (wakeUpTick != std::numeric_limits<uint64>::max()) {
+                const auto wakeUpTime = startTime + std::chrono::milliseconds(wakeUpTick);
+                const auto delay = std::chrono::duration_cast<std::chrono::microseconds>(wakeUpTime - Clock::now()).count();
+
+                // Round up, so the Timers are due when the thread wakes up
+                timeout = static_cast<int>(jlimit<int64>(0, std::numeric_limits<int>::max(), (delay + 999) / 1000));
+            }
+        }
+
+        if (timeout != 0)
+            wakeUpEvent.wait(timeout);
+    }
+}
+
+void TimerWheel::insert(Timer& timer, uint64 earliestTick)
+{
+    const auto dueTick = jmax(timer.dueTick, earliestTick);
+    const auto delta = dueTick - currentTick;
+    Timer** list = &overflow;
+
+    for (int level = 0; level < numLevels; ++level) {
+        if (delta < (uint64(1) << (bitsPerLevel * (level + 1)))) {
+            list = &slots[level][(dueTick >> (bitsPerLevel * level)) & (numSlots - 1)];
+            break;
+        }
+    }
+
+    timer.list = list;
+    timer.previous = nullptr;
+    timer.next = *list;
+
+    if (timer.next)
+        timer.next->previous = &timer;
+
+    *list = &timer;
+    ++numTimers;
+}
+
+void TimerWheel::unlink(Timer& timer)
+{
+    if (timer.previous)
+        timer.previous->next = timer.next;
+    else
+        *timer.list = timer.next;
+
+    if (timer.next)
+        timer.next->previous = timer.previous;
+
+    timer.list = nullptr;
+    timer.previous = nullptr;
+    timer.next = nullptr;
+    --numTimers;
+
+    // May delete the Timer
+    std::shared_ptr<Timer> keepAlive;
+    keepAlive.swap(timer.keepAlive);
+}
+
+void TimerWheel::reinsertAll(Timer** list)
+{
+    Timer* timer = *list;
+    *list = nullptr;
+
+    while (timer) {
+        const auto next = timer->next;
+        --numTimers;
+
+        // Timers that are due now go into the current slot of level 0, which is processed next
+        insert(*timer, currentTick);
+        timer = next;
+    }
+}
+
+void TimerWheel::advanceTo(uint64 tick, std::vector<std::shared_ptr<Timer>>& dueTimers)
+{
+    // Nothing to fire on the way
+    if (numTimers == 0) {
+        currentTick = jmax(currentTick, tick);
+        return;
+    }
+
+    while (currentTick < tick) {
+        ++currentTick;
+
+        // When a level wraps around, move the Timers of the next slot in the level above down
+        for (int level = 1; level < numLevels; ++level) {
+            if ((currentTick & ((uint64(1) << (bitsPerLevel * level)) - 1)) != 0)
+                break;
+
+            reinsertAll(&slots[level][(currentTick >> (bitsPerLevel * level)) & (numSlots - 1)]);
+
+            if (level == numLevels - 1)
+                reinsertAll(&overflow);
+        }
+
+        auto& slot = slots[0][currentTick & (numSlots - 1)];
+
+        while (slot) {
+            dueTimers.push_back(slot->keepAlive);
+            unlink(*slot);
+        }
+    }
+}
+
+uint64 TimerWheel::findWakeUpTick() const
+{
+    if (numTimers == 0)
+        return std::numeric_limits<uint64>::max();
+
+    // Either a slot in level 0 has Timers, or the Timers are in higher levels, which are moved down when level 0 wraps around
+    for (uint64 tick = currentTick + 1;; ++tick) {
+        if (slots[0][tick & (numSlots - 1)] || (tick & (numSlots - 1)) == 0)
+            return tick;
+    }
+}
+}
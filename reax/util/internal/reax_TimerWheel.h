@@ -0,0 +1,75 @@
+#pragma once
+
+namespace detail {
+/**
+ A hierarchical timer wheel with a single thread, which runs the timers of the time-based operators (debounce, sample and interval).
+
+ A tick is one millisecond. There are 4 levels of 64 slots: Level 0 has a slot for each of the next 64 ticks, level 1 for each of the next 64 * 64 ticks, and so on. Timers in higher levels are moved down when a lower level wraps around. Timers that are due after 64^4 ticks (about 4.6 hours) wait in an overflow list.
+
+ The slots are intrusive lists, so scheduling, rescheduling and cancelling a timer is O(1), and doesn't allocate. The thread only wakes up when a timer is due, or when a level wraps around while timers are waiting in higher levels.
+
+ Callbacks are called on the wheel's thread, one at a time, so they should return quickly.
+ */
+class TimerWheel : private juce::Thread
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /// A timer that can be scheduled on a TimerWheel. It can be rescheduled and cancelled any number of times.
+    class Timer
+    {
+    public:
+        explicit Timer(const std::function<void()>& callback);
+
+    private:
+        friend class TimerWheel;
+
+        const std::function<void()> callback;
+
+        // Guarded by the wheel's lock. The wheel holds a reference while the Timer is scheduled.
+        std::shared_ptr<Timer> keepAlive;
+        Timer** list = nullptr;
+        Timer* previous = nullptr;
+        Timer* next = nullptr;
+        juce::uint64 dueTick = 0;
+    };
+
+    /// Returns the wheel that's shared by all operators. Its thread is started on first use.
+    static TimerWheel& getShared();
+
+    ~TimerWheel();
+
+    /// Schedules the Timer to fire at `when`. If it's already scheduled, it's moved. Can be called from any thread, including from a Timer callback.
+    void schedule(const std::shared_ptr<Timer>& timer, Clock::time_point when);
+
+    /// Removes the Timer from the wheel. If its callback is being called at the moment, it's not waited for.
+    void cancel(const std::shared_ptr<Timer>& timer);
+
+private:
+    static const int numLevels = 4;
+    static const int bitsPerLevel = 6;
+    static const int numSlots = 1 << bitsPerLevel;
+
+    const Clock::time_point startTime;
+    juce::CriticalSection criticalSection;
+    juce::WaitableEvent wakeUpEvent;
+    Timer* slots[numLevels][numSlots];
+    Timer* overflow = nullptr;
+    juce::uint64 currentTick = 0;
+    juce::uint64 wakeUpTick = 0;
+    int numTimers = 0;
+
+    TimerWheel();
+
+    void run() override;
+
+    // Must be called with the lock held
+    void insert(Timer& timer, juce::uint64 earliestTick);
+    void unlink(Timer& timer);
+    void reinsertAll(Timer** list);
+    void advanceTo(juce::uint64 tick, std::vector<std::shared_ptr<Timer>>& dueTimers);
+    juce::uint64 findWakeUpTick() const;
+
+    JUCE_DECLARE_NON_COPYABLE(TimerWheel)
+};
+}
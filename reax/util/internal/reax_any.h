@@ -40,6 +40,10 @@ public:
     template<typename T>
     using is_any = std::is_base_of<any, typename std::decay<T>::type>;
 
+    // True if an instance holding a From can be read as a To without converting it first. This is the case if both types are the same, or if both are arithmetic (get() converts between arithmetic types).
+    template<typename From, typename To>
+    using has_same_representation = std::integral_constant<bool, std::is_same<typename std::decay<From>::type, typename std::decay<To>::type>::value || (is_arithmetic<From>::value && is_arithmetic<To>::value)>;
+
 
     template<typename T>
     explicit any(T&& value, typename std::enable_if<is_enum<T>::value>::type* = 0)
@@ -73,6 +77,9 @@ public:
     /// Default copy assignment operator. If the wrapped value is scalar, it is copied. Otherwise, it is shared by reference.
     any& operator=(const any&) = default;
 
+    /// Default move assignment operator
+    any& operator=(any&&) = default;
+
     ///@{
     /**
      Extracts the held value as a T. Throws an exception if the held value is not a T.
@@ -133,6 +140,42 @@ public:
     }
     ///@}
 
+    /**
+     Marks this instance as given away by whoever emitted it, so `release()` may move the held object out. Copies of this instance aren't marked, but moving the instance keeps the mark.
+     */
+    void markAsMovable()
+    {
+        movable.isSet = true;
+    }
+
+    ///@{
+    /**
+     Like `get()`, but if this instance is marked as movable (see markAsMovable), and it's the only instance that holds the object, the object is moved out instead of copied. Scalars are returned by value.
+     
+     Only call this if nobody reads this instance's value afterwards, e.g. in the last subscriber that's notified with it.
+     */
+    template<typename T>
+    T release(typename std::enable_if<!is_class<T>::value>::type* = 0) const
+    {
+        return get<T>();
+    }
+
+    template<typename T>
+    T release(typename std::enable_if<is_class<T>::value>::type* = 0) const
+    {
+        if (!is<T>())
+            throw typeMismatchError<T>();
+
+        // The object was created non-const, its emitter has given it away, and no other instance shares it. The fence makes sure that others are done reading it before it's moved.
+        if (movable.isSet && objectValue.use_count() == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return std::move(const_cast<TypedObject<T>*>(getObjectPointer<T>())->t);
+        }
+
+        return getObjectPointer<T>()->t;
+    }
+    ///@}
+
     /**
      Checks whether the held value is a T. For class types, it returns true only if the wrapped type is exactly T, not a base class.
      */
@@ -257,6 +300,37 @@ private:
     // The held value, if it's non-scalar.
     std::shared_ptr<Object> objectValue;
 
+    // Whether release() may move the object out. Copies of an any don't inherit it, but moves do.
+    struct MovableFlag
+    {
+        MovableFlag() = default;
+
+        MovableFlag(const MovableFlag&) {}
+
+        MovableFlag(MovableFlag&& other)
+        : isSet(other.isSet)
+        {
+            other.isSet = false;
+        }
+
+        MovableFlag& operator=(const MovableFlag&)
+        {
+            isSet = false;
+            return *this;
+        }
+
+        MovableFlag& operator=(MovableFlag&& other)
+        {
+            isSet = other.isSet;
+            other.isSet = false;
+            return *this;
+        }
+
+        bool isSet = false;
+    };
+
+    MovableFlag movable;
+
     template<typename T>
     std::runtime_error typeMismatchError() const
     {
@@ -0,0 +1,149 @@
+#pragma once
+
+namespace detail {
+template<typename T>
+class LockFreeBroadcastBase
+{
+protected:
+    LockFreeBroadcastBase(size_t minimumCapacity, int numReaders)
+    : capacity(nextPowerOfTwo(juce::jmax<size_t>(minimumCapacity, 1))),
+      slots(new T[capacity]),
+      cursors(new std::atomic<size_t>[static_cast<size_t>(numReaders)]),
+      numReaders(numReaders)
+    {
+        // There must be at least one reader.
+        jassert(numReaders > 0);
+
+        for (int i = 0; i < numReaders; ++i)
+            cursors[i].store(0, std::memory_order_relaxed);
+
+        subject.subscribeMoving([this](T&& newValue) {
+                   publish(std::move(newValue));
+               })
+            .disposedBy(disposeBag);
+    }
+
+    const size_t capacity;
+    const std::unique_ptr<T[]> slots;
+    const std::unique_ptr<std::atomic<size_t>[]> cursors;
+    const int numReaders;
+    std::atomic<size_t> writePosition{ 0 };
+    PublishSubject<T> subject;
+    DisposeBag disposeBag;
+
+private:
+    // Only called from the Observer side, which gets one value at a time
+    void publish(T&& value)
+    {
+        const auto position = writePosition.load(std::memory_order_relaxed);
+
+        // The slot may only be overwritten once every reader has read it. Otherwise, the value is dropped.
+        for (int i = 0; i < numReaders; ++i) {
+            if (position - cursors[i].load(std::memory_order_acquire) >= capacity)
+                return;
+        }
+
+        slots[position & (capacity - 1)] = std::move(value);
+        writePosition.store(position + 1, std::memory_order_release);
+    }
+
+    static size_t nextPowerOfTwo(size_t n)
+    {
+        size_t result = 1;
+        while (result < n)
+            result <<= 1;
+
+        return result;
+    }
+};
+}
+
+/**
+ An `Observer` that broadcasts all retrieved values to a fixed number of readers on other threads, without locking.
+
+ Values are written once into a preallocated ring. Each reader has its own position in the ring, and reads every value in order, directly from the ring. This is cheaper than one LockFreeTarget per reader, which would copy each value into each reader's queue.
+
+ A slot in the ring is only reused once every reader has read it. If the slowest reader is `capacity` values behind, new values are dropped until it catches up. So every reader must read regularly.
+
+ T must be default-constructible and move-assignable. Values passed as rvalues are moved into the ring when possible.
+ */
+template<typename T>
+class LockFreeBroadcast : private detail::LockFreeBroadcastBase<T>, public Observer<T>
+{
+    typedef detail::LockFreeBroadcastBase<T> Base;
+
+public:
+    /**
+     Creates a new instance with the given number of readers. The ring is allocated upfront.
+
+     **The given `capacity` may get rounded up to a different value.**
+     */
+    LockFreeBroadcast(size_t capacity, int numReaders)
+    : Base(capacity, numReaders),
+      Observer<T>(Base::subject)
+    {}
+
+    /// Returns the number of readers.
+    int getNumReaders() const { return Base::numReaders; }
+
+    /**
+     Calls `function` with a const reference to the next value for the given reader, if there is one. The value is not copied. It stays valid until `function` returns.
+
+     Returns `true` iff there was a value.
+
+     Does not lock or allocate. Each reader must only be used from one thread at a time. Different readers may be used from different threads.
+     */
+    template<typename Function>
+    bool tryVisit(int readerIndex, Function&& function)
+    {
+        jassert(juce::isPositiveAndBelow(readerIndex, Base::numReaders));
+
+        auto& cursor = Base::cursors[readerIndex];
+        const auto position = cursor.load(std::memory_order_relaxed);
+
+        if (position == Base::writePosition.load(std::memory_order_acquire))
+            return false;
+
+        function(static_cast<const T&>(Base::slots[position & (Base::capacity - 1)]));
+        cursor.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     Reads the next value for the given reader (if there is one) and assigns it to `value`.
+
+     Returns `true` iff there was a value. If it returns `false`, then `value` is untouched.
+
+     Does not lock. Does not allocate dynamic memory, unless `value` does during assignment.
+     */
+    template<typename U>
+    bool tryRead(int readerIndex, U& value)
+    {
+        return tryVisit(readerIndex, [&value](const T& next) { value = next; });
+    }
+
+    /**
+     Reads all remaining values for the given reader (if there are any) and assigns the last (newest) value to `value`.
+
+     Returns `true` iff there was a value. If it returns `false`, then `value` is untouched.
+     */
+    template<typename U>
+    bool tryReadAll(int readerIndex, U& value)
+    {
+        jassert(juce::isPositiveAndBelow(readerIndex, Base::numReaders));
+
+        auto& cursor = Base::cursors[readerIndex];
+        const auto position = cursor.load(std::memory_order_relaxed);
+        const auto end = Base::writePosition.load(std::memory_order_acquire);
+
+        if (position == end)
+            return false;
+
+        value = Base::slots[(end - 1) & (Base::capacity - 1)];
+        cursor.store(end, std::memory_order_release);
+        return true;
+    }
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LockFreeBroadcast)
+};
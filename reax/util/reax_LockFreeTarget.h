@@ -7,8 +7,8 @@ class LockFreeTargetBase
 protected:
     LockFreeTargetBase()
     {
-        subject.subscribe([this](const T& newValue) {
-                   queue.enqueue(newValue);
+        subject.subscribeMoving([this](T&& newValue) {
+                   queue.enqueue(std::move(newValue));
                })
             .disposedBy(disposeBag);
     }